@@ -0,0 +1,186 @@
+#include "blockReplace.hpp"
+
+#include "LegacyEditor/code/Chunk/v12.hpp"
+#include "LegacyEditor/utils/dataManager.hpp"
+
+
+namespace editor::chunk {
+
+
+    BlockMapping::BlockMapping() : myTable(65536) {
+        for (u32 i = 0; i < 65536; i++) {
+            myTable[i] = static_cast<u16>(i);
+        }
+    }
+
+
+    BlockMapping::BlockMapping(std::initializer_list<std::pair<u16, u16>> thePairs) : BlockMapping() {
+        for (const auto& [from, to] : thePairs) {
+            set(from, to);
+        }
+    }
+
+
+    void BlockMapping::set(c_u16 theFrom, c_u16 theTo) {
+        myTable[theFrom] = theTo;
+        myHasEntries = true;
+    }
+
+
+    static constexpr u16 PALETTE_EMPTY = 0xFFFF;
+    static constexpr u32 GRID_HEADER_SIZE = 128;
+
+
+    static u16 readLE16(c_u8* ptr) {
+        return static_cast<u16>(ptr[0] | ptr[1] << 8);
+    }
+
+
+    static void writeLE16(u8* ptr, c_u16 value) {
+        ptr[0] = static_cast<u8>(value);
+        ptr[1] = static_cast<u8>(value >> 8);
+    }
+
+
+    /**
+     * Walks every grid of the chunk and calls func(format, header, gridData)
+     * on it, stopping at the first non SUCCESS result.
+     */
+    template<class Func>
+    static int forEachGrid(u8* buffer, c_u32 size, Func&& func) {
+        DataManager manager(buffer, size);
+        c_i16 version = static_cast<i16>(manager.readInt16());
+
+        u32 sectionStart;
+        if (version == 12) {
+            // 2 version + 24 chunk header + 50 section header
+            sectionStart = 76;
+        } else if (version == 13) {
+            // + 2 maxGridAmount
+            sectionStart = 78;
+            manager.incrementPointer(2);
+        } else {
+            return INVALID_ARGUMENT;
+        }
+
+        if (size < sectionStart) {
+            return INVALID_SAVE;
+        }
+
+        manager.seek(sectionStart - 50);
+        c_u32 maxSectionAddress = manager.readInt16() << 8U;
+        u16 sectionJumpTable[16];
+        for (u16& address : sectionJumpTable) {
+            address = manager.readInt16();
+        }
+        c_u8* sizeOfSubChunks = manager.ptr;
+
+        if (maxSectionAddress == 0) {
+            return SUCCESS;
+        }
+
+        for (int section = 0; section < 16; section++) {
+            c_u32 address = sectionJumpTable[section];
+            if (address == maxSectionAddress) {
+                break;
+            }
+            if (sizeOfSubChunks[section] == 0U) {
+                continue;
+            }
+
+            c_u32 headerStart = sectionStart + address;
+            if EXPECT_FALSE (headerStart + GRID_HEADER_SIZE > size) {
+                return INVALID_SAVE;
+            }
+
+            u8* sectionHeader = buffer + headerStart;
+            for (u32 gridIndex = 0; gridIndex < 64; gridIndex++) {
+                u8* header = sectionHeader + gridIndex * 2;
+                c_u16 format = header[1] >> 4U;
+                c_u32 offset = ((0x0FU & header[1]) << 8U | header[0]) * 4;
+                c_u32 gridPosition = headerStart + GRID_HEADER_SIZE + offset;
+
+                if EXPECT_FALSE (format != V12_0_UNO && gridPosition + V12_GRID_SIZES[format] > size) {
+                    return INVALID_SAVE;
+                }
+
+                if (c_int status = func(format, header, buffer + gridPosition); status != SUCCESS) {
+                    return status;
+                }
+            }
+        }
+        return SUCCESS;
+    }
+
+
+    /// @return the number of u16 palette / block entries stored at the start of the grid.
+    static u32 getEntryCount(c_u16 format) {
+        switch (format) {
+            case V12_1_BIT:
+            case V12_1_BIT_SUBMERGED:
+                return 2;
+            case V12_2_BIT:
+            case V12_2_BIT_SUBMERGED:
+                return 4;
+            case V12_3_BIT:
+            case V12_3_BIT_SUBMERGED:
+                return 8;
+            case V12_4_BIT:
+            case V12_4_BIT_SUBMERGED:
+                return 16;
+            case V12_8_FULL:
+                return 64;
+            case V12_8_FULL_SUBMERGED:
+                return 128;
+            default:
+                return 0;
+        }
+    }
+
+
+    int replaceBlocksInPlace(u8* buffer, c_u32 size, const BlockMapping& mapping, bool& isChanged) {
+        if (mapping.empty()) {
+            return SUCCESS;
+        }
+
+        // a single-block grid's header is its block, whose top nibble must stay 0
+        u32 gridCount = 0;
+        int status = forEachGrid(buffer, size, [&](c_u16 format, c_u8* header, c_u8*) -> int {
+            gridCount++;
+            if (format != V12_0_UNO) {
+                return getEntryCount(format) != 0 ? SUCCESS : INVALID_SAVE;
+            }
+            return mapping[readLE16(header)] >= 0x1000 ? NOT_IMPLEMENTED : SUCCESS;
+        });
+        if (status != SUCCESS) {
+            return status;
+        }
+
+        // sections that are not stored are air, and there is nowhere to put a replacement for it
+        if (mapping[0] != 0 && gridCount != 16 * 64) {
+            return NOT_IMPLEMENTED;
+        }
+
+        return forEachGrid(buffer, size, [&](c_u16 format, u8* header, u8* gridData) -> int {
+            if (format == V12_0_UNO) {
+                c_u16 value = readLE16(header);
+                isChanged |= mapping[value] != value;
+                writeLE16(header, mapping[value]);
+                return SUCCESS;
+            }
+
+            c_u32 entryCount = getEntryCount(format);
+            for (u32 i = 0; i < entryCount; i++) {
+                u8* entry = gridData + i * 2;
+                c_u16 value = readLE16(entry);
+                if (value != PALETTE_EMPTY) {
+                    isChanged |= mapping[value] != value;
+                    writeLE16(entry, mapping[value]);
+                }
+            }
+            return SUCCESS;
+        });
+    }
+
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <initializer_list>
+#include <utility>
+
+#include "lce/processor.hpp"
+
+#include "LegacyEditor/utils/error_status.hpp"
+
+
+namespace editor::chunk {
+
+
+    /**
+     * Maps block values (blockID << 4 | dataTag) to their replacement.\n
+     * Values without an entry map to themselves.
+     */
+    class BlockMapping {
+        u16_vec myTable;
+        bool myHasEntries = false;
+
+    public:
+        BlockMapping();
+        BlockMapping(std::initializer_list<std::pair<u16, u16>> thePairs);
+
+        void set(u16 theFrom, u16 theTo);
+
+        ND u16 operator[](c_u16 theValue) const { return myTable[theValue]; }
+        ND bool empty() const { return !myHasEntries; }
+    };
+
+
+    /**
+     * Replaces blocks inside a decompressed (and RLE decoded) V12 / V13 chunk
+     * without decoding it into ChunkData.\n
+     * Only palettes, single-block grid headers and full grids are rewritten;
+     * the position bitplanes are left untouched. Submerged grids share their
+     * palette with the block grid, so both layers are replaced.\n
+     * The buffer is validated before anything is written, so on failure
+     * it is left unchanged.
+     * @param buffer the chunk, starting at its version
+     * @param size size of the chunk
+     * @param mapping
+     * @param isChanged set if any block was replaced, left alone otherwise
+     * @return SUCCESS, INVALID_ARGUMENT if the chunk is not V12 / V13,
+     * NOT_IMPLEMENTED if a single-block grid would need a value its header
+     * cannot hold (>= 0x1000) or air is replaced in a chunk that leaves
+     * sections out, or INVALID_SAVE if the chunk is malformed.
+     */
+    MU ND int replaceBlocksInPlace(u8* buffer, u32 size, const BlockMapping& mapping, bool& isChanged);
+
+
+}
@@ -0,0 +1,339 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "lce/processor.hpp"
+
+#include "LegacyEditor/code/Chunk/chunkData.hpp"
+
+
+namespace editor::chunk {
+
+
+    // #####################################################
+    // #               Layouts
+    // #####################################################
+
+    /**
+     * Each layout describes how one chunk version stores its blocks.\n
+     * Every block is exposed as (blockID << 4 | dataTag), the same value
+     * ChunkData::getBlock returns, so callers never see the storage.
+     */
+
+    /// V12 / V13: u16 per block, (blockID << 4 | dataTag | waterlogged << 15).
+    struct AquaticLayout {
+        static constexpr int X_STRIDE = 4096;
+        static constexpr int Z_STRIDE = 256;
+        static constexpr int Y_STRIDE = 1;
+
+        struct Storage {
+            u16* blocks;
+        };
+
+        static Storage storage(ChunkData& chunk) { return {chunk.newBlocks.data()}; }
+
+        static int index(c_int xIn, c_int yIn, c_int zIn) {
+            return yIn + Z_STRIDE * zIn + X_STRIDE * xIn;
+        }
+
+        static u16 get(const Storage& store, c_int offset) {
+            return store.blocks[offset];
+        }
+
+        static void set(const Storage& store, c_int offset, c_u16 block) {
+            store.blocks[offset] = block;
+        }
+    };
+
+
+    /// shared by the u8 block id + nibble data layouts.
+    struct NibbleStorage {
+        u8* blocks;
+        u8* data;
+
+        ND u16 get(c_int offset) const {
+            c_u8 nibble = data[offset / 2];
+            c_u16 dataTag = offset % 2 == 0 ? nibble & 0x0F : (nibble & 0xF0) >> 4;
+            return static_cast<u16>(blocks[offset] << 4 | dataTag);
+        }
+
+        void set(c_int offset, c_u16 block) const {
+            blocks[offset] = static_cast<u8>(block >> 4);
+            u8& nibble = data[offset / 2];
+            if (offset % 2 == 0) {
+                nibble = (nibble & 0xF0) | (block & 0x0F);
+            } else {
+                nibble = (nibble & 0x0F) | (block & 0x0F) << 4;
+            }
+        }
+    };
+
+
+    /// V8 / V9 / V11: u8 block ids and u4 data, indexed (y, z, x).
+    struct ElytraLayout {
+        static constexpr int X_STRIDE = 1;
+        static constexpr int Z_STRIDE = 16;
+        static constexpr int Y_STRIDE = 256;
+
+        using Storage = NibbleStorage;
+
+        static Storage storage(ChunkData& chunk) {
+            return {chunk.oldBlocks.data(), chunk.blockData.data()};
+        }
+
+        static int index(c_int xIn, c_int yIn, c_int zIn) {
+            return yIn * Y_STRIDE + zIn * Z_STRIDE + xIn;
+        }
+
+        static u16 get(const Storage& store, c_int offset) { return store.get(offset); }
+        static void set(const Storage& store, c_int offset, c_u16 block) { store.set(offset, block); }
+    };
+
+
+    /// V10: the NBT chunk layout, two 128-tall halves indexed (z, x, y).
+    struct NBTLayout {
+        static constexpr int X_STRIDE = 128;
+        static constexpr int Z_STRIDE = 2048;
+        static constexpr int Y_STRIDE = 1;
+
+        using Storage = NibbleStorage;
+
+        static Storage storage(ChunkData& chunk) {
+            return {chunk.oldBlocks.data(), chunk.blockData.data()};
+        }
+
+        static int index(c_int xIn, c_int yIn, c_int zIn) {
+            return (yIn % 128) + xIn * X_STRIDE + zIn * Z_STRIDE + 32768 * (yIn > 127);
+        }
+
+        static u16 get(const Storage& store, c_int offset) { return store.get(offset); }
+        static void set(const Storage& store, c_int offset, c_u16 block) { store.set(offset, block); }
+    };
+
+
+    // #####################################################
+    // #               Views
+    // #####################################################
+
+
+    /// An axis-aligned box of blocks, both corners inclusive.
+    struct BlockBox {
+        int minX = 0, minY = 0, minZ = 0;
+        int maxX = 15, maxY = 255, maxZ = 15;
+
+        /// clamps the box to the 16x256x16 bounds of a chunk.
+        ND BlockBox clamped() const {
+            return {std::max(minX, 0), std::max(minY, 0), std::max(minZ, 0),
+                    std::min(maxX, 15), std::min(maxY, 255), std::min(maxZ, 15)};
+        }
+
+        ND bool empty() const { return minX > maxX || minY > maxY || minZ > maxZ; }
+    };
+
+
+    template<class Layout>
+    class ColumnView {
+        typename Layout::Storage myStore;
+        int myBase;
+
+    public:
+        ColumnView(typename Layout::Storage theStore, c_int theBase)
+            : myStore(theStore), myBase(theBase) {}
+
+        ND u16 get(c_int yIn) const { return Layout::get(myStore, myBase + offset(yIn)); }
+        void set(c_int yIn, c_u16 block) const { Layout::set(myStore, myBase + offset(yIn), block); }
+        ND u16 operator[](c_int yIn) const { return get(yIn); }
+
+        /// Only the aquatic layout stores a column contiguously.
+        ND std::span<u16, 256> span() const requires std::is_same_v<Layout, AquaticLayout> {
+            return std::span<u16, 256>(myStore.blocks + myBase, 256);
+        }
+
+    private:
+        static int offset(c_int yIn) { return Layout::index(0, yIn, 0); }
+    };
+
+
+    /**
+     * A 16x16x16 cube of blocks, sectionY is 0 to 15.
+     */
+    template<class Layout>
+    class SectionView {
+        typename Layout::Storage myStore;
+        int myBaseY;
+
+    public:
+        SectionView(typename Layout::Storage theStore, c_int theSectionY)
+            : myStore(theStore), myBaseY(theSectionY * 16) {}
+
+        ND int baseY() const { return myBaseY; }
+
+        /// yIn is local to the section.
+        ND u16 get(c_int xIn, c_int yIn, c_int zIn) const {
+            return Layout::get(myStore, Layout::index(xIn, myBaseY + yIn, zIn));
+        }
+
+        void set(c_int xIn, c_int yIn, c_int zIn, c_u16 block) const {
+            Layout::set(myStore, Layout::index(xIn, myBaseY + yIn, zIn), block);
+        }
+    };
+
+
+    /**
+     * Typed access to the blocks of one chunk.\n
+     * The chunk version is resolved once by withBlockView, so every
+     * access below is an inlined index computation with no switch.
+     *
+     * Callbacks passed to forEachBlock receive (x, y, z, block);
+     * if they return a u16 it is written back as the new block.
+     */
+    template<class Layout>
+    class BlockView {
+        typename Layout::Storage myStore;
+
+    public:
+        using layout_type = Layout;
+
+        explicit BlockView(ChunkData& theChunk) : myStore(Layout::storage(theChunk)) {}
+
+        ND u16 get(c_int xIn, c_int yIn, c_int zIn) const {
+            return Layout::get(myStore, Layout::index(xIn, yIn, zIn));
+        }
+
+        void set(c_int xIn, c_int yIn, c_int zIn, c_u16 block) const {
+            Layout::set(myStore, Layout::index(xIn, yIn, zIn), block);
+        }
+
+        ND ColumnView<Layout> columnView(c_int xIn, c_int zIn) const {
+            return {myStore, Layout::index(xIn, 0, zIn)};
+        }
+
+        ND SectionView<Layout> sectionView(c_int sectionY) const {
+            return {myStore, sectionY};
+        }
+
+        template<class Func>
+        void forEachBlock(Func&& func) const {
+            forEachInBox(BlockBox{}, std::forward<Func>(func));
+        }
+
+        /// iterates the box in the layout's storage order.
+        template<class Func>
+        void forEachInBox(const BlockBox& boxIn, Func&& func) const {
+            const BlockBox box = boxIn.clamped();
+            if (box.empty()) { return; }
+
+            if constexpr (Layout::Y_STRIDE == 1) {
+                for (int x = box.minX; x <= box.maxX; x++) {
+                    for (int z = box.minZ; z <= box.maxZ; z++) {
+                        for (int y = box.minY; y <= box.maxY; y++) {
+                            visit(x, y, z, func);
+                        }
+                    }
+                }
+            } else {
+                for (int y = box.minY; y <= box.maxY; y++) {
+                    for (int z = box.minZ; z <= box.maxZ; z++) {
+                        for (int x = box.minX; x <= box.maxX; x++) {
+                            visit(x, y, z, func);
+                        }
+                    }
+                }
+            }
+        }
+
+        void fillBox(const BlockBox& boxIn, c_u16 block) const {
+            const BlockBox box = boxIn.clamped();
+            if (box.empty()) { return; }
+
+            if constexpr (std::is_same_v<Layout, AquaticLayout>) {
+                // columns are contiguous, so fill each as one run
+                for (int x = box.minX; x <= box.maxX; x++) {
+                    for (int z = box.minZ; z <= box.maxZ; z++) {
+                        u16* column = myStore.blocks + Layout::index(x, box.minY, z);
+                        std::fill_n(column, box.maxY - box.minY + 1, block);
+                    }
+                }
+            } else {
+                forEachInBox(box, [block](int, int, int, u16) { return block; });
+            }
+        }
+
+        /// @return the number of blocks that were replaced.
+        int replaceInBox(const BlockBox& boxIn, c_u16 from, c_u16 to) const {
+            int count = 0;
+            forEachInBox(boxIn, [&](int, int, int, c_u16 block) -> u16 {
+                if (block != from) { return block; }
+                count++;
+                return to;
+            });
+            return count;
+        }
+
+    private:
+        template<class Func>
+        void visit(c_int xIn, c_int yIn, c_int zIn, Func& func) const {
+            c_int offset = Layout::index(xIn, yIn, zIn);
+            c_u16 block = Layout::get(myStore, offset);
+            if constexpr (std::is_void_v<std::invoke_result_t<Func&, int, int, int, u16>>) {
+                func(xIn, yIn, zIn, block);
+            } else {
+                c_u16 result = func(xIn, yIn, zIn, block);
+                if (result != block) {
+                    Layout::set(myStore, offset, result);
+                }
+            }
+        }
+    };
+
+
+    /**
+     * Resolves the chunk's layout once and calls func with a typed BlockView.
+     * @param chunk a chunk that has already been read
+     * @param func called as func(BlockView<Layout>)
+     * @return false if the chunk's version has no known block layout.
+     */
+    template<class Func>
+    bool withBlockView(ChunkData& chunk, Func&& func) {
+        switch (chunk.lastVersion) {
+            case 8:
+            case 9:
+            case 11:
+                func(BlockView<ElytraLayout>(chunk));
+                return true;
+            case 10:
+                func(BlockView<NBTLayout>(chunk));
+                return true;
+            case 12:
+            case 13:
+                func(BlockView<AquaticLayout>(chunk));
+                return true;
+            default:
+                return false;
+        }
+    }
+
+
+    template<class Func>
+    bool forEachBlock(ChunkData& chunk, Func&& func) {
+        return withBlockView(chunk, [&func](const auto& view) { view.forEachBlock(func); });
+    }
+
+
+    inline bool fillBox(ChunkData& chunk, const BlockBox& box, c_u16 block) {
+        return withBlockView(chunk, [&](const auto& view) { view.fillBox(box, block); });
+    }
+
+
+    /// @return the number of blocks that were replaced, or -1 for an unknown version.
+    inline int replaceInBox(ChunkData& chunk, const BlockBox& box, c_u16 from, c_u16 to) {
+        int count = -1;
+        withBlockView(chunk, [&](const auto& view) { count = view.replaceInBox(box, from, to); });
+        return count;
+    }
+
+
+}
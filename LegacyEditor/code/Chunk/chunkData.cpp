@@ -1,29 +1,17 @@
 #include "chunkData.hpp"
 
-#include "LegacyEditor/utils/NBT.hpp"
 #include "lce/blocks/block_ids.hpp"
 
-
-namespace editor::chunk {
+#include "LegacyEditor/code/Chunk/blockView.hpp"
+#include "LegacyEditor/utils/NBT.hpp"
 
 
-    ChunkData::~ChunkData() {
-        if (NBTData != nullptr) {
-            NBTData->NbtFree();
-            delete NBTData;
-            NBTData = nullptr;
-        }
-    }
+namespace editor::chunk {
 
 
     void ChunkData::defaultNBT() {
-        if (NBTData != nullptr) {
-            NBTData->toType<NBTTagCompound>()->deleteAll();
-            delete NBTData;
-        }
-
-        NBTData = new NBTBase(new NBTTagCompound(), TAG_COMPOUND);
-        auto* chunkRootNbtData = static_cast<NBTTagCompound*>(NBTData->data);
+        NBTData.set(new NBTBase(new NBTTagCompound(), TAG_COMPOUND));
+        auto* chunkRootNbtData = NBTData.get()->toType<NBTTagCompound>();
         auto* entities = new NBTTagList();
         auto* tileEntities = new NBTTagList();
         auto* tileTicks = new NBTTagList();
@@ -40,20 +28,13 @@ namespace editor::chunk {
 
     MU void ChunkData::convertNBTToAquatic() {
         newBlocks = u16_vec(65536);
+        const NBTLayout::Storage nbt = NBTLayout::storage(*this);
+        const AquaticLayout::Storage aquatic = AquaticLayout::storage(*this);
         for (int xIter = 0; xIter < 16; xIter++) {
             for (int zIter = 0; zIter < 16; zIter++) {
                 for (int yIter = 0; yIter < 256; yIter++) {
-                    c_int offset = (yIter % 128) + xIter * 128 + zIter * 128 * 16 + 32768 * (yIter > 127);
-                    c_u16 blockID = oldBlocks[offset];
-                    u16 dataTag;
-                    if (offset % 2 == 0) {
-                        dataTag = blockData[offset / 2] & 0x0F;
-                    } else {
-                        dataTag = (blockData[offset / 2] & 0xF0) >> 4;
-                    }
-                    u16 elytraBlock = blockID << 4 | dataTag;
-                    c_int AquaticOffset = yIter + 4096 * zIter + 256 * xIter;
-                    newBlocks[AquaticOffset] = elytraBlock;
+                    AquaticLayout::set(aquatic, AquaticLayout::index(xIter, yIter, zIter),
+                                       NBTLayout::get(nbt, NBTLayout::index(xIter, yIter, zIter)));
                 }
             }
         }
@@ -64,20 +45,13 @@ namespace editor::chunk {
 
     MU void ChunkData::convertOldToAquatic() {
         newBlocks = u16_vec(65536);
+        const ElytraLayout::Storage elytra = ElytraLayout::storage(*this);
+        const AquaticLayout::Storage aquatic = AquaticLayout::storage(*this);
         for (int xIter = 0; xIter < 16; xIter++) {
             for (int zIter = 0; zIter < 16; zIter++) {
                 for (int yIter = 0; yIter < 256; yIter++) {
-                    c_int offset = yIter * 256 + zIter * 16 + xIter;
-                    c_u16 blockID = oldBlocks[offset];
-                    u16 dataTag;
-                    if (offset % 2 == 0) {
-                        dataTag = blockData[offset / 2] & 0x0F;
-                    } else {
-                        dataTag = (blockData[offset] & 0xF0) >> 8;
-                    }
-                    u16 elytraBlock = blockID << 4 | dataTag;
-                    c_int AquaticOffset = yIter + 4096 * zIter + 256 * xIter;
-                    newBlocks[AquaticOffset] = elytraBlock;
+                    AquaticLayout::set(aquatic, AquaticLayout::index(xIter, yIter, zIter),
+                                       ElytraLayout::get(elytra, ElytraLayout::index(xIter, yIter, zIter)));
                 }
             }
         }
@@ -111,32 +85,19 @@ namespace editor::chunk {
                        c_int xIn, c_int yIn, c_int zIn,
                        c_u16 block, c_u16 data, c_bool waterlogged, c_bool isSubmerged) {
         switch (lastVersion) {
-            case 10: {
-                int offset = (yIn % 128) + xIn * 128 + zIn * 128 * 16;
-                offset += 32768 * (yIn > 127);
-                oldBlocks[offset] = block;
-                if (offset % 2 == 0) {
-                    blockData[offset] = (blockData[offset] & 0x0F) | data << 4;
-                } else {
-                    blockData[offset] = (blockData[offset] & 0xF0) | data;
-                }
+            case 10:
+                NBTLayout::set(NBTLayout::storage(*this),
+                               NBTLayout::index(xIn, yIn, zIn), block << 4 | data);
                 break;
-            }
             case 8:
             case 9:
-            case 11: {
-                c_int offset = yIn * 256 + zIn * 16 + xIn;
-                oldBlocks[offset] = block;
-                if (offset % 2 == 0) {
-                    blockData[offset] = (blockData[offset] & 0x0F) | data << 4;
-                } else {
-                    blockData[offset] = (blockData[offset] & 0xF0) | data;
-                }
-            }
-            break;
+            case 11:
+                ElytraLayout::set(ElytraLayout::storage(*this),
+                                  ElytraLayout::index(xIn, yIn, zIn), block << 4 | data);
+                break;
             case 12:
             case 13: {
-                c_int offset = yIn + 256 * zIn + 4096 * xIn;
+                c_int offset = AquaticLayout::index(xIn, yIn, zIn);
                 u16 value = block << 4 | data;
                 if (waterlogged) {
                     value |= 0x8000;
@@ -156,8 +117,8 @@ namespace editor::chunk {
 
     MU void ChunkData::placeBlock(c_int xIn, c_int yIn, c_int zIn, c_u16 block, c_bool isSubmerged) {
         c_bool waterloggedIn = block & 0x8000;
-        c_bool dataIn = block & 0x0F;
-        c_bool blockIn = block & 0x7FF0 >> 4;
+        c_u16 dataIn = block & 0x0F;
+        c_u16 blockIn = (block & 0x7FF0) >> 4;
         placeBlock(xIn, yIn, zIn, blockIn, dataIn, waterloggedIn, isSubmerged);
     }
 
@@ -165,36 +126,15 @@ namespace editor::chunk {
     /// Returns (blockID << 4 | dataTag).
     u16 ChunkData::getBlock(c_int xIn, c_int yIn, c_int zIn) {
         switch (lastVersion) {
-            case 10: {
-                int offset = (yIn % 128) + xIn * 128 + zIn * 128 * 16;
-                offset += 32768 * (yIn > 127);
-                c_u16 blockID = oldBlocks[offset];
-                u16 dataTag;
-                if (offset % 2 == 0) {
-                    dataTag = blockData[offset] & 0x0F;
-                } else {
-                    dataTag = (blockData[offset] & 0xF0) >> 4;
-                }
-                return blockID << 4 | dataTag;
-            }
+            case 10:
+                return NBTLayout::get(NBTLayout::storage(*this), NBTLayout::index(xIn, yIn, zIn));
             case 8:
             case 9:
-            case 11: {
-                c_int offset = yIn * 256 + zIn * 16 + xIn;
-                c_u16 blockID = oldBlocks[offset];
-                u16 dataTag;
-                if (offset % 2 == 0) {
-                    dataTag = blockData[offset] & 0x0F;
-                } else {
-                    dataTag = (blockData[offset] & 0xF0) >> 4;
-                }
-                return blockID << 4 | dataTag;
-            }
+            case 11:
+                return ElytraLayout::get(ElytraLayout::storage(*this), ElytraLayout::index(xIn, yIn, zIn));
             case 12:
-            case 13: {
-                c_int offset = yIn + 256 * zIn + 4096 * xIn;
-                return newBlocks[offset];
-            }
+            case 13:
+                return newBlocks[AquaticLayout::index(xIn, yIn, zIn)];
             default:
                 return 0;
         }
@@ -3,10 +3,9 @@
 #include "lce/processor.hpp"
 
 #include "LegacyEditor/utils/error_status.hpp"
+#include "LegacyEditor/utils/lazyNBT.hpp"
 
 
-class NBTBase;
-
 namespace editor::chunk {
 
 
@@ -26,7 +25,8 @@ namespace editor::chunk {
         u8_vec skyLight;            //
         u8_vec heightMap;           //
         u8_vec biomes;              //
-        NBTBase* NBTData = nullptr; //
+        /// only parsed once asked for, see LazyNBT.
+        LazyNBT NBTData;            //
         i16 terrainPopulated = 0;   //
         i64 lastUpdate = 0;         //
         i64 inhabitedTime = 0;      //
@@ -40,8 +40,6 @@ namespace editor::chunk {
         i32 lastVersion = 0;
         bool validChunk = false;
 
-        ~ChunkData();
-
         MU ND std::string getCoords() const;
 
         void defaultNBT();
@@ -58,6 +56,7 @@ namespace editor::chunk {
 
 
         /// Returns (blockID << 4 | dataTag).
+        /// For whole-chunk edits use withBlockView / forEachBlock (blockView.hpp).
         u16 getBlock(int xIn, int yIn, int zIn);
 
 
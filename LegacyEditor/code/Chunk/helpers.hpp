@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cassert>
 #include <cstring>
 
 #include "lce/processor.hpp"
@@ -92,8 +93,8 @@ namespace editor::chunk {
     static std::vector<u8*> readGetDataBlockVector(ChunkData* chunkData, DataManager* managerIn) {
         std::vector<u8*> dataArray(SIZE);
         for (int i = 0; i < SIZE; i++) {
-            dataArray[i] = managerIn->ptr;
             c_u32 index = toIndex(managerIn->readInt32());
+            dataArray[i] = managerIn->ptr;
             managerIn->incrementPointer(index);
             chunkData->DataGroupCount += index;
         }
@@ -101,9 +102,14 @@ namespace editor::chunk {
     }
 
 
+    /// the most writeDataBlock writes: per half, its size, 128 section indices and all 128 sections.
+    static constexpr u32 DATA_BLOCK_WRITE_BOUND = 2 * (4 + 128 + 128 * 128);
+
+
     static void writeDataBlock(DataManager* managerIn, const u8_vec& dataIn)  {
         static constexpr int GRID_COUNT = 64;
         static constexpr int DATA_SECTION_SIZE = 128;
+        assert(managerIn->getPosition() + DATA_BLOCK_WRITE_BOUND <= managerIn->size);
 
         static u32_vec sectionOffsets;
         sectionOffsets.reserve(GRID_COUNT);
@@ -25,7 +25,10 @@ namespace editor::chunk {
         allocChunk();
 
         dataManager->readInt8();
-        c_auto* nbt = NBT::readTag(*dataManager);
+        // the arena drops the whole tree once the few kept tags are copied out of it,
+        // and the block and light arrays are copied straight out of the chunk's data
+        NBTArena arena;
+        c_auto* nbt = NBT::readTag(*dataManager, arena, true);
         auto* chunkNBT = nbt->toType<NBTTagCompound>();
 
         chunkData->lastVersion = 10;
@@ -47,15 +50,15 @@ namespace editor::chunk {
         chunkData->blockLight = createAndCopy(chunkNBT->getByteArray("BlockLight"), 32768);
 
 
-        chunkData->NBTData = new NBTBase(new NBTTagCompound(), TAG_COMPOUND);
-        chunkData->NBTData->toType<NBTTagCompound>()->setTag("Entities", chunkNBT->getTag("Entities").copy());
-        chunkData->NBTData->toType<NBTTagCompound>()->setTag("TileEntities", chunkNBT->getTag("TileEntities").copy());
-        chunkData->NBTData->toType<NBTTagCompound>()->setTag("TileTicks", chunkNBT->getTag("TileTicks").copy());
-
-        // IDK if this is enough nbt is cringe
-        chunkNBT->deleteAll();
-        delete chunkNBT;
-        delete nbt;
+        // the kept tags go straight into the chunk's own arena, one bump-allocated copy
+        // that is dropped along with the chunk, instead of a malloc and a free per node
+        NBTArena& chunkArena = chunkData->NBTData.getArena();
+        auto* chunkRoot = chunkArena.create<NBTBase>(makeByType(TAG_COMPOUND, &chunkArena));
+        auto* chunkRootNbtData = chunkRoot->toType<NBTTagCompound>();
+        chunkRootNbtData->setTag("Entities", chunkNBT->getTag("Entities").copy(&chunkArena));
+        chunkRootNbtData->setTag("TileEntities", chunkNBT->getTag("TileEntities").copy(&chunkArena));
+        chunkRootNbtData->setTag("TileTicks", chunkNBT->getTag("TileTicks").copy(&chunkArena));
+        chunkData->NBTData.set(chunkRoot);
 
         chunkData->validChunk = true;
 
@@ -1,5 +1,6 @@
 #include "v11.hpp"
 
+#include <cassert>
 #include <cstring>
 
 #include "LegacyEditor/utils/NBT.hpp"
@@ -52,7 +53,7 @@ namespace editor::chunk {
         dataManager->readBytes(256, chunkData->biomes.data());
 
         if (*dataManager->ptr == 0x0A) {
-            chunkData->NBTData = NBT::readTag(*dataManager);
+            chunkData->NBTData.readRaw(*dataManager);
         }
 
         chunkData->validChunk = true;
@@ -240,14 +241,17 @@ namespace editor::chunk {
         writeDataBlock(dataManager, chunkData->skyLight);
         writeDataBlock(dataManager, chunkData->blockLight);
 
+        assert(dataManager->getPosition() + 256 + 2 + 256 <= dataManager->size);
         dataManager->writeBytes(chunkData->heightMap.data(), 256);
         dataManager->writeInt16(chunkData->terrainPopulated);
         dataManager->writeBytes(chunkData->biomes.data(), 256);
+        // the NBT is appended by ChunkManager::writeChunk, as it has no upper bound
+    }
 
 
-        if (chunkData->NBTData != nullptr) {
-            NBT::writeTag(chunkData->NBTData, *dataManager);
-        }
+    u32 ChunkV11::getWriteBound() {
+        // writeBlockData does not write anything yet
+        return 26 + 3 * DATA_BLOCK_WRITE_BOUND + 256 + 2 + 256;
     }
 
 
@@ -49,6 +49,8 @@ namespace editor::chunk {
         MU void allocChunk() const;
         MU void readChunk() const;
         MU void writeChunk();
+        /// the most writeChunk writes, with the version ChunkManager writes before it.
+        ND static u32 getWriteBound();
     };
 
 }
\ No newline at end of file
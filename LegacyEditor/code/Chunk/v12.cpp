@@ -1,11 +1,13 @@
 #include "v12.hpp"
 
+#include <cassert>
 #include <cstring>
 #include <algorithm>
 
 #include "LegacyEditor/code/Chunk/helpers.hpp"
 #include "LegacyEditor/utils/NBT.hpp"
 #include "LegacyEditor/utils/dataManager.hpp"
+#include "LegacyEditor/utils/dataReader.hpp"
 
 
 namespace editor::chunk {
@@ -46,7 +48,7 @@ namespace editor::chunk {
         dataManager->readBytes(256, chunkData->biomes.data());
 
         if (*dataManager->ptr == 0xA) {
-            chunkData->NBTData = NBT::readTag(*dataManager);
+            chunkData->NBTData.readRaw(*dataManager);
         }
 
         chunkData->validChunk = true;
@@ -299,6 +301,170 @@ namespace editor::chunk {
     }
 
 
+    /**
+     * Whether a palette grid is what writeGrid makes of the blocks it holds: the fewest
+     * bits, the palette in order of first use without repeats, and the rest 0xFFFF.
+     */
+    static bool isGridWritten(c_u8* theGrid, c_u32 theBits) {
+        c_u32 paletteSize = 1U << theBits;
+        u32 used = 0;
+        for (u32 index = 0; index < 64; index++) {
+            c_u32 row = index / 8;
+            c_u32 column = index % 8;
+            u32 paletteIndex = 0;
+            for (u32 bit = 0; bit < theBits; bit++) {
+                paletteIndex |= (theGrid[paletteSize * 2 + row + bit * 8] >> (7 - column) & 1U) << bit;
+            }
+            if (paletteIndex > used) {
+                return false;
+            }
+            if (paletteIndex == used) {
+                used++;
+            }
+        }
+
+        c_u32 bitsForUsed = used <= 2 ? 1 : used <= 4 ? 2 : used <= 8 ? 3 : 4;
+        if (used < 2 || bitsForUsed != theBits) {
+            return false;
+        }
+        for (u32 index = 0; index < paletteSize; index++) {
+            c_u16 block = endian::load<Endian::Little, u16>(theGrid + index * 2);
+            if (index >= used) {
+                if (block != 0xFFFF) {
+                    return false;
+                }
+                continue;
+            }
+            for (u32 other = 0; other < index; other++) {
+                if (endian::load<Endian::Little, u16>(theGrid + other * 2) == block) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+
+    /// a full grid is only written for more than 16 different blocks.
+    static bool isFullGridWritten(c_u8* theGrid) {
+        u16 blocks[64];
+        endian::loadArray<Endian::Little>(blocks, theGrid, 64);
+        std::sort(blocks, blocks + 64);
+        return std::unique(blocks, blocks + 64) - blocks > 16;
+    }
+
+
+    /**
+     * Whether a light block is what writeDataBlock makes of it: the pieces that are not
+     * all 0 or all 255 numbered in order, and nothing else after the header.
+     * @return the block's size, 0 if it is not.
+     */
+    static u32 getLightBlockSize(c_u8* theBlock, c_u32 theSize) {
+        static constexpr u32 DATA_SECTION_SIZE = 128;
+        if (theSize < 4 + DATA_SECTION_SIZE) {
+            return 0;
+        }
+        c_u32 pieceCount = endian::load<Endian::Big, u32>(theBlock);
+        c_u64 blockSize = 4 + static_cast<u64>(pieceCount + 1) * DATA_SECTION_SIZE;
+        if (pieceCount > DATA_SECTION_SIZE || blockSize > theSize) {
+            return 0;
+        }
+
+        c_u8* header = theBlock + 4;
+        u32 written = 0;
+        for (u32 index = 0; index < DATA_SECTION_SIZE; index++) {
+            if (header[index] == DATA_SECTION_SIZE || header[index] == DATA_SECTION_SIZE + 1) {
+                continue;
+            }
+            c_u8* piece = header + toIndex(written);
+            if (header[index] != written++ || is0_128_slow(piece) || is255_128_slow(piece)) {
+                return 0;
+            }
+        }
+        return written == pieceCount ? static_cast<u32>(blockSize) : 0;
+    }
+
+
+    u32 ChunkV12::findHeightMap(c_u8* theData, c_u32 theSize) {
+        // version, x, z, last update and inhabited time, then the section tables
+        constexpr u32 H_BEGIN = 26;
+        constexpr u32 H_SECT_START = H_BEGIN + 50;
+        if (theData == nullptr || theSize < H_SECT_START) {
+            return 0;
+        }
+
+        // every section has to be where, and laid out how, writeBlockData would put it
+        u32 sectionJump = 0;
+        for (int section = 0; section < SECTION_COUNT; section++) {
+            c_u32 address = endian::load<Endian::Big, u16>(theData + H_BEGIN + 2 + section * 2);
+            c_u32 sectionSize = theData[H_BEGIN + 34 + section];
+            if (address != sectionJump * 256) {
+                return 0;
+            }
+            if (sectionSize == 0) {
+                continue;
+            }
+            c_u32 sectionStart = H_SECT_START + address;
+            if (sectionStart + sectionSize * 256 > theSize || is0_128_slow(theData + sectionStart)) {
+                return 0;
+            }
+
+            u32 gridsSize = 0;
+            for (int gridIndex = 0; gridIndex < GRID_COUNT; gridIndex++) {
+                c_u16 gridID = endian::load<Endian::Little, u16>(theData + sectionStart + gridIndex * 2);
+                c_u32 format = gridID >> 12U;
+                if (format == V12_0_UNO) {
+                    continue;
+                }
+                // submerged grids are not written yet
+                if ((format & 1U) != 0 || V12_GRID_SIZES[format] == 0 || (gridID & 0x0FFFU) * 4 != gridsSize) {
+                    return 0;
+                }
+                c_u8* grid = theData + sectionStart + GRID_SIZE + gridsSize;
+                gridsSize += V12_GRID_SIZES[format];
+                if (GRID_SIZE + gridsSize > sectionSize * 256) {
+                    return 0;
+                }
+                if (format == V12_8_FULL ? !isFullGridWritten(grid) : !isGridWritten(grid, format / 2)) {
+                    return 0;
+                }
+            }
+
+            if ((GRID_SIZE + gridsSize + 255) / 256 != sectionSize) {
+                return 0;
+            }
+            for (u32 index = sectionStart + GRID_SIZE + gridsSize; index < sectionStart + sectionSize * 256; index++) {
+                if (theData[index] != 0) {
+                    return 0;
+                }
+            }
+            sectionJump += sectionSize;
+        }
+        if (endian::load<Endian::Big, u16>(theData + H_BEGIN) != sectionJump) {
+            return 0;
+        }
+
+        // sky light, then block light, each in two blocks
+        u32 offset = H_SECT_START + sectionJump * 256;
+        for (int block = 0; block < 4; block++) {
+            if (offset > theSize) {
+                return 0;
+            }
+            c_u32 blockSize = getLightBlockSize(theData + offset, theSize - offset);
+            if (blockSize == 0) {
+                return 0;
+            }
+            offset += blockSize;
+        }
+
+        // the height map, terrain populated and the biomes
+        if (offset + 256 + 2 + 256 > theSize) {
+            return 0;
+        }
+        return offset;
+    }
+
+
     // #####################################################
     // #               Write Section
     // #####################################################
@@ -315,14 +481,17 @@ namespace editor::chunk {
         writeDataBlock(dataManager, chunkData->skyLight);
         writeDataBlock(dataManager, chunkData->blockLight);
 
+        assert(dataManager->getPosition() + 256 + 2 + 256 <= dataManager->size);
         dataManager->writeBytes(chunkData->heightMap.data(), 256);
         dataManager->writeInt16(chunkData->terrainPopulated);
         dataManager->writeBytes(chunkData->biomes.data(), 256);
+        // the NBT is appended by ChunkManager::writeChunk, as it has no upper bound
+    }
 
-        if (chunkData->NBTData != nullptr) {
-            NBT::writeTag(chunkData->NBTData, *dataManager);
-        }
 
+    u32 ChunkV12::getWriteBound() {
+        // 26 bytes of version, coordinates and timestamps, then the 50 byte section tables
+        return 26 + 50 + SECTION_COUNT * SECTION_WRITE_BOUND + 2 * DATA_BLOCK_WRITE_BOUND + 256 + 2 + 256;
     }
 
 
@@ -368,6 +537,7 @@ namespace editor::chunk {
             u32 gridIndex = 0;
 
             sectJumpTable[sectionIndex] = CURRENT_INC_SECT_JUMP;
+            assert(CURRENT_SECTION_START + SECTION_WRITE_BOUND <= dataManager->size);
 
             dataManager->ptr = dataManager->data + H_SECT_START + CURRENT_INC_SECT_JUMP + GRID_SIZE;
 
@@ -476,11 +646,10 @@ namespace editor::chunk {
             }
 
             // write grid header in subsection
-            dataManager->setLittleEndian();
+            DataWriter<Endian::Little> little(*dataManager);
             for (size_t index = 0; index < GRID_COUNT; index++) {
-                dataManager->writeInt16AtOffset(CURRENT_SECTION_START + 2 * index, gridHeader[index]);
+                little.writeInt16AtOffset(CURRENT_SECTION_START + 2 * index, gridHeader[index]);
             }
-            dataManager->setBigEndian();
 
             // write section size to section size table
             if (is0_128_slow(dataManager->data + CURRENT_SECTION_START)) {
@@ -489,6 +658,9 @@ namespace editor::chunk {
             } else {
                 last_section_size = (GRID_SIZE + sectionSize + 255) / 256;
                 last_section_jump += last_section_size;
+                // sections are 256 byte aligned, zero the padding up to the next one
+                u8* sectionEnd = dataManager->data + CURRENT_SECTION_START + last_section_size * 256;
+                std::memset(dataManager->ptr, 0, sectionEnd - dataManager->ptr);
             }
             sectSizeTable[sectionIndex] = last_section_size;
         }
@@ -521,19 +693,19 @@ namespace editor::chunk {
         u16_vec& blockLocations, u8 blockMap[MAP_SIZE]) const {
 
         // write the palette data
-        dataManager->setLittleEndian();
+        DataWriter<Endian::Little> little(*dataManager);
+        DataWriter<Endian::Big> big(*dataManager);
         // #pragma unroll
         for (size_t blockIndex = 0; blockIndex < BlockCount; blockIndex++) {
-            dataManager->writeInt16(blockVector[blockIndex]);
+            little.writeInt16(blockVector[blockIndex]);
         }
-        dataManager->setBigEndian();
 
         // fill rest of empty palette with 0xFF's
         // TODO: IDK if this is actually necessary
         if constexpr (EmptyCount != 0) {
             // #pragma unroll EmptyCount
             for (size_t rest = 0; rest < EmptyCount; rest++) {
-                dataManager->writeInt16(0xFFFF);
+                little.writeInt16(0xFFFF);
             }
         }
 
@@ -546,7 +718,7 @@ namespace editor::chunk {
                 c_u64 pos = blockLocations[locIndex];
                 position |= (pos >> bitIndex & 1U) << (GRID_COUNT - locIndex - 1);
             }
-            dataManager->writeInt64(position);
+            big.writeInt64(position);
         }
 
         // clear the table
@@ -561,12 +733,11 @@ namespace editor::chunk {
     /// used to writeGameData full block data, instead of using palette.
     void ChunkV12::writeWithMaxBlocks(const u16_vec& blockVector,
         const u16_vec& blockLocations, u8 blockMap[MAP_SIZE]) const {
-        dataManager->setLittleEndian();
+        DataWriter<Endian::Little> little(*dataManager);
         for (size_t i = 0; i < GRID_COUNT; i++) {
             c_u16 blockPos = blockLocations[i];
-            dataManager->writeInt16(blockVector[blockPos]);
+            little.writeInt16(blockVector[blockPos]);
         }
-        dataManager->setBigEndian();
 
         for (c_u16 block : blockVector) {
             blockMap[block] = 0;
@@ -586,15 +757,15 @@ namespace editor::chunk {
         const u16_vec& sbmrgLocations, u8 blockMap[MAP_SIZE]) const {
 
         // write the palette data
-        dataManager->setLittleEndian();
+        DataWriter<Endian::Little> little(*dataManager);
+        DataWriter<Endian::Big> big(*dataManager);
         for (size_t blockIndex = 0; blockIndex < BlockCount; blockIndex++) {
-            dataManager->writeInt16(blockVector[blockIndex]);
+            little.writeInt16(blockVector[blockIndex]);
         }
-        dataManager->setBigEndian();
         // fill rest of empty palette with 0xFF's
         // TODO: IDK if this is actually necessary
         for (size_t rest = 0; rest < EmptyCount; rest++) {
-            dataManager->writeInt16(0xFFFF);
+            little.writeInt16(0xFFFF);
         }
 
         //  write the position data
@@ -606,7 +777,7 @@ namespace editor::chunk {
                 c_u64 pos = blockLocations[locIndex];
                 position |= (pos >> bitIndex & 1U) << (GRID_COUNT - locIndex - 1);
             }
-            dataManager->writeInt64(position);
+            big.writeInt64(position);
         }
 
         //  write the sbmgd data
@@ -618,7 +789,7 @@ namespace editor::chunk {
                 c_u64 pos = sbmrgLocations[locIndex];
                 position |= (pos >> bitIndex & 1U) << (GRID_COUNT - locIndex - 1);
             }
-            dataManager->writeInt64(position);
+            big.writeInt64(position);
         }
 
         // clear the table
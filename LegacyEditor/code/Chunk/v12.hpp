@@ -54,6 +54,9 @@ namespace editor::chunk {
         static constexpr int GRID_COUNT = 64;
         static constexpr int GRID_SIZE = 128;
         static constexpr int MAP_SIZE = 65536;
+        /// a section is at most its grid header and 64 full submerged grids, 256 byte aligned.
+        static constexpr u32 SECTION_WRITE_BOUND =
+                (GRID_SIZE + GRID_COUNT * V12_GRID_SIZES[V12_8_FULL_SUBMERGED] + 255) / 256 * 256;
 
         // Read Section
 
@@ -83,6 +86,18 @@ namespace editor::chunk {
         MU void allocChunk() const;
         MU void readChunk() const;
         MU void writeChunk() const;
+        /// the most writeChunk writes, with the version ChunkManager writes before it.
+        ND static u32 getWriteBound();
+
+        /**
+         * Finds the height map of an uncompressed V12 payload without decoding the chunk,
+         * so it can be edited in place.\n
+         * It is only found if readChunk and writeChunk would give back the same bytes:
+         * every section, grid and light block has to be laid out the way writeChunk
+         * lays it out, and there can be no submerged grids, which it does not write yet.
+         * @return the height map's offset, 0 if it is not found.
+         */
+        MU static u32 findHeightMap(c_u8* theData, u32 theSize);
 
     };
 }
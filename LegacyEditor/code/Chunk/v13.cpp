@@ -6,6 +6,7 @@
 #include "LegacyEditor/code/Chunk/helpers.hpp"
 #include "LegacyEditor/utils/NBT.hpp"
 #include "LegacyEditor/utils/dataManager.hpp"
+#include "LegacyEditor/utils/dataReader.hpp"
 
 
 namespace editor::chunk {
@@ -47,7 +48,7 @@ namespace editor::chunk {
         dataManager->readBytes(256, chunkData->biomes.data());
 
         if (*dataManager->ptr == 0x0A) {
-            chunkData->NBTData = NBT::readTag(*dataManager);
+            chunkData->NBTData.readRaw(*dataManager);
         }
 
         chunkData->validChunk = true;
@@ -291,11 +292,7 @@ namespace editor::chunk {
         dataManager->writeBytes(chunkData->heightMap.data(), 256);
         dataManager->writeInt16(chunkData->terrainPopulated);
         dataManager->writeBytes(chunkData->biomes.data(), 256);
-
-        if (chunkData->NBTData != nullptr) {
-            NBT::writeTag(chunkData->NBTData, *dataManager);
-        }
-
+        // the NBT is appended by ChunkManager::writeChunk, as it has no upper bound
     }
 
     void ChunkV13::writeBlockData() const {
@@ -397,11 +394,10 @@ namespace editor::chunk {
             }
 
             // write grid header in subsection
-            dataManager->setLittleEndian();
+            DataWriter<Endian::Little> little(*dataManager);
             for (size_t index = 0; index < GRID_COUNT; index++) {
-                dataManager->writeInt16AtOffset(CURRENT_SECTION_START + 2 * index, gridHeader[index]);
+                little.writeInt16AtOffset(CURRENT_SECTION_START + 2 * index, gridHeader[index]);
             }
-            dataManager->setBigEndian();
 
             // write section size to section size table
             if (is0_128_slow(dataManager->data + CURRENT_SECTION_START)) {
@@ -441,16 +437,16 @@ namespace editor::chunk {
     void ChunkV13::writeGrid(u16_vec& blockVector, u16_vec& blockLocations, u8 blockMap[MAP_SIZE]) const {
 
         // write the block data
-        dataManager->setLittleEndian();
+        DataWriter<Endian::Little> little(*dataManager);
+        DataWriter<Endian::Big> big(*dataManager);
         for (size_t blockIndex = 0; blockIndex < BlockCount; blockIndex++) {
-            dataManager->writeInt16(blockVector[blockIndex]);
+            little.writeInt16(blockVector[blockIndex]);
         }
-        dataManager->setBigEndian();
 
         // fill rest of empty palette with 0xFF's
         // TODO: IDK if this is actually necessary
         for (size_t rest = 0; rest < EmptyCount; rest++) {
-            dataManager->writeInt16(0xFFFF);
+            little.writeInt16(0xFFFF);
         }
 
         //  write the position data
@@ -462,7 +458,7 @@ namespace editor::chunk {
                 c_u64 pos = blockLocations[locIndex];
                 position |= (pos >> bitIndex & 1) << (GRID_COUNT - locIndex - 1);
             }
-            dataManager->writeInt64(position);
+            big.writeInt64(position);
         }
 
         // clear the table
@@ -476,12 +472,11 @@ namespace editor::chunk {
     /// make this copy all u16 blocks from the grid location or whatnot
     /// used to writeGameData full block data, instead of using palette.
     void ChunkV13::writeWithMaxBlocks(const u16_vec& blockVector, const u16_vec& blockLocations, u8 blockMap[MAP_SIZE]) const {
-        dataManager->setLittleEndian();
+        DataWriter<Endian::Little> little(*dataManager);
         for (size_t i = 0; i < GRID_COUNT; i++) {
             c_u16 blockPos = blockLocations[i];
-            dataManager->writeInt16(blockVector[blockPos]);
+            little.writeInt16(blockVector[blockPos]);
         }
-        dataManager->setBigEndian();
 
         for (c_u16 block : blockVector) {
             blockMap[block] = 0;
@@ -1,7 +1,278 @@
 #include "ConsoleParser.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <set>
 
-int ConsoleParser::readListing(const Data &dataIn) {
+#include "include/zlib-1.2.12/zlib.h"
+
+#include "LegacyEditor/utils/dataReader.hpp"
+#include "LegacyEditor/utils/deflateFile.hpp"
+#include "LegacyEditor/utils/outputBuffer.hpp"
+#include "LegacyEditor/code/threaded.hpp"
+
+
+MappedFile* ConsoleParser::getInputFile() const {
+    MappedFile& fileIn = myListingPtr->mySourceFile;
+    if (fileIn.getPath() != myFilePath && fileIn.open(myFilePath) != SUCCESS) {
+        return nullptr;
+    }
+    return &fileIn;
+}
+
+
+/**
+ * The listing cache holds one save's inflated listing, behind a header keyed by
+ * the save's size, modification time and a crc32 of all of it, so an edited,
+ * replaced or copied-over save is never read from a stale cache. Checking it
+ * reads the save once, which is still far less than inflating and parsing it.\n
+ * The listing starts LISTING_CACHE_HEADER_SIZE in, and is parsed straight out of
+ * a copy-on-write mapping of the cache: the files borrow from it like from a slab.
+ * That includes each region's chunk index, its location and timestamp tables,
+ * so there is no second copy of those. PS4 and Switch regions are files of
+ * their own, outside the listing, and are not cached.
+ */
+static constexpr u32 LISTING_CACHE_MAGIC = 0x4345434C; // "LCEC"
+static constexpr u16 LISTING_CACHE_VERSION = 3;
+static constexpr u32 LISTING_CACHE_HEADER_SIZE = 64;
+/// crc32 takes a uInt length, so larger saves are fed to it in pieces.
+static constexpr u32 LISTING_CACHE_CRC_STEP = 1U << 30;
+
+
+struct ListingCacheKey {
+    u64 sourceSize = 0;
+    u64 sourceTime = 0;
+    u32 sourceCrc = 0;
+};
+
+
+static u32 getSourceCrc(const MappedFile& theSource) {
+    c_u64 size = theSource.size();
+    uLong crc = crc32(0, nullptr, 0);
+    for (u64 offset = 0; offset < size; offset += LISTING_CACHE_CRC_STEP) {
+        c_u64 length = std::min<u64>(size - offset, LISTING_CACHE_CRC_STEP);
+        crc = crc32(crc, theSource.data() + offset, static_cast<uInt>(length));
+    }
+    return static_cast<u32>(crc);
+}
+
+
+static bool getListingCacheKey(const MappedFile& theSource, ListingCacheKey& theKey) {
+    std::error_code error;
+    c_auto sourceTime = fs::last_write_time(theSource.getPath(), error);
+    if (error) {
+        return false;
+    }
+    theKey.sourceSize = theSource.size();
+    theKey.sourceTime = static_cast<u64>(sourceTime.time_since_epoch().count());
+    theKey.sourceCrc = getSourceCrc(theSource);
+    return true;
+}
+
+
+/// FNV-1a, unlike std::hash it is the same in every build, so a cache is always found again.
+static u64 hashCachePath(const std::string& thePath) {
+    u64 hash = 0xCBF29CE484222325ULL;
+    for (const char chara : thePath) {
+        hash = (hash ^ static_cast<u8>(chara)) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+
+fs::path ConsoleParser::getListingCachePath() const {
+    const fs::path& cacheFolder = myListingPtr->myReadSettings.getListingCacheFolder();
+    // a .bin's listing comes out of its STFS package along with its FileInfo
+    if (cacheFolder.empty() || myListingPtr->myReadSettings.getIsXbox360BIN()) {
+        return {};
+    }
+    std::error_code error;
+    const std::string sourcePath = fs::absolute(myFilePath, error).string();
+    char cacheName[32];
+    snprintf(cacheName, sizeof(cacheName), "%016llx.lcecache",
+             static_cast<unsigned long long>(hashCachePath(sourcePath)));
+    return cacheFolder / cacheName;
+}
+
+
+bool ConsoleParser::readCachedListing() {
+    const fs::path cachePath = getListingCachePath();
+    myIsListingCacheMissed = !cachePath.empty();
+    std::error_code error;
+    if (cachePath.empty() || !fs::exists(cachePath, error)) {
+        return false;
+    }
+
+    const MappedFile* fileIn = getInputFile();
+    ListingCacheKey key;
+    if (fileIn == nullptr || !getListingCacheKey(*fileIn, key)) {
+        return false;
+    }
+
+    // files may be edited in place, which has to leave the cache alone
+    auto cacheIn = std::make_shared<MappedFile>();
+    if (cacheIn->open(cachePath, true) != SUCCESS || cacheIn->size() < LISTING_CACHE_HEADER_SIZE) {
+        return false;
+    }
+    c_u8* header = cacheIn->data();
+    c_u32 listingSize = endian::load<Endian::Little, u32>(header + 28);
+    if (endian::load<Endian::Little, u32>(header) != LISTING_CACHE_MAGIC
+        || endian::load<Endian::Little, u16>(header + 4) != LISTING_CACHE_VERSION
+        || header[6] != static_cast<u8>(myConsole)
+        || endian::load<Endian::Little, u64>(header + 8) != key.sourceSize
+        || endian::load<Endian::Little, u64>(header + 16) != key.sourceTime
+        || endian::load<Endian::Little, u32>(header + 24) != key.sourceCrc
+        || listingSize > cacheIn->size() - LISTING_CACHE_HEADER_SIZE) {
+        return false;
+    }
+
+    const Data listing(cacheIn->data() + LISTING_CACHE_HEADER_SIZE, listingSize);
+    // the mapping lives as long as the last file borrowing from it
+    const editor::FileSlab slab(listing.data, [cacheIn](u8*) {});
+    if (parseListing(listing, slab) != SUCCESS) {
+        myListingPtr->myAllFiles.clear();
+        return false;
+    }
+    myIsListingCacheMissed = false;
+    return true;
+}
+
+
+int ConsoleParser::writeCachedListing(const Data &dataIn) const {
+    const fs::path cachePath = getListingCachePath();
+    if (cachePath.empty()) {
+        return SUCCESS;
+    }
+
+    const MappedFile* fileIn = getInputFile();
+    ListingCacheKey key;
+    if (fileIn == nullptr || !getListingCacheKey(*fileIn, key)) {
+        return FILE_ERROR;
+    }
+
+    // the buffer can be larger than what was inflated into it, the footer is where it ends
+    if (dataIn.size < FILELISTING_HEADER_SIZE) {
+        return INVALID_SAVE;
+    }
+    DataManager managerIn(dataIn, consoleIsBigEndian(myConsole));
+    c_u32 indexOffset = managerIn.readInt32();
+    c_u32 fileCount = managerIn.readInt32();
+    managerIn.incrementPointer2();
+    c_u64 footerSize = managerIn.readInt16() <= 1 ? fileCount : static_cast<u64>(fileCount) * 144;
+    if (indexOffset + footerSize > dataIn.size) {
+        return INVALID_SAVE;
+    }
+    c_u32 listingSize = static_cast<u32>(indexOffset + footerSize);
+
+    u8 header[LISTING_CACHE_HEADER_SIZE] = {};
+    endian::store<Endian::Little, u32>(header, LISTING_CACHE_MAGIC);
+    endian::store<Endian::Little, u16>(header + 4, LISTING_CACHE_VERSION);
+    header[6] = static_cast<u8>(myConsole);
+    endian::store<Endian::Little, u64>(header + 8, key.sourceSize);
+    endian::store<Endian::Little, u64>(header + 16, key.sourceTime);
+    endian::store<Endian::Little, u32>(header + 24, key.sourceCrc);
+    endian::store<Endian::Little, u32>(header + 28, listingSize);
+
+    // written aside and renamed over, so a reader never maps half a cache
+    std::error_code error;
+    fs::create_directories(cachePath.parent_path(), error);
+    fs::path tempPath = cachePath;
+    tempPath += ".tmp";
+    FILE* fileOut = fopen(tempPath.string().c_str(), "wb");
+    if (fileOut == nullptr) {
+        return FILE_ERROR;
+    }
+    bool isWritten = fwrite(header, 1, LISTING_CACHE_HEADER_SIZE, fileOut) == LISTING_CACHE_HEADER_SIZE
+                     && fwrite(dataIn.data, 1, listingSize, fileOut) == listingSize;
+    isWritten = fclose(fileOut) == 0 && isWritten;
+    if (isWritten) {
+        fs::rename(tempPath, cachePath, error);
+    }
+    if (!isWritten || error) {
+        fs::remove(tempPath, error);
+        return FILE_ERROR;
+    }
+    return SUCCESS;
+}
+
+
+int ConsoleParser::readListing(Data &dataIn) {
+    if (myIsListingCacheMissed) {
+        writeCachedListing(dataIn);
+        myIsListingCacheMissed = false;
+    }
+
+    const Data listing(dataIn.data, dataIn.size);
+    const editor::FileSlab slab(dataIn.data);
+    dataIn.reset();
+    return parseListing(listing, slab);
+}
+
+
+int ConsoleParser::readListingCopy(const Data &dataIn) {
+    return parseListing(dataIn, nullptr);
+}
+
+
+/// what a listing entry is, from its name alone.
+static lce::FILETYPE getFileTypeFromName(const std::string& fileName) {
+    if (fileName.ends_with(".mcr")) {
+        if (fileName.starts_with("DIM-1")) {
+            return lce::FILETYPE::REGION_NETHER;
+        }
+        if (fileName.starts_with("DIM1")) {
+            return lce::FILETYPE::REGION_END;
+        }
+        if (fileName.starts_with("r")) {
+            return lce::FILETYPE::REGION_OVERWORLD;
+        }
+        return lce::FILETYPE::NONE;
+    }
+    if (fileName == "entities.dat") {
+        return lce::FILETYPE::ENTITY_OVERWORLD;
+    }
+    if (fileName.ends_with("entities.dat")) {
+        if (fileName.starts_with("DIM-1")) {
+            return lce::FILETYPE::ENTITY_NETHER;
+        }
+        if (fileName.starts_with("DIM1/")) {
+            return lce::FILETYPE::ENTITY_END;
+        }
+        return lce::FILETYPE::NONE;
+    }
+    if (fileName == "level.dat") {
+        return lce::FILETYPE::LEVEL;
+    }
+    if (fileName.starts_with("data/map_")) {
+        return lce::FILETYPE::MAP;
+    }
+    if (fileName == "data/villages.dat") {
+        return lce::FILETYPE::VILLAGE;
+    }
+    if (fileName == "data/largeMapDataMappings.dat") {
+        return lce::FILETYPE::DATA_MAPPING;
+    }
+    if (fileName.starts_with("data/")) {
+        return lce::FILETYPE::STRUCTURE;
+    }
+    if (fileName.ends_with(".grf")) {
+        return lce::FILETYPE::GRF;
+    }
+    if (fileName.starts_with("players/") || fileName.find('/') == -1LLU) {
+        return lce::FILETYPE::PLAYER;
+    }
+    printf("Unknown File: %s\n", fileName.c_str());
+    return lce::FILETYPE::NONE;
+}
+
+
+/**
+ * With a slab, each file's data points into it, so reading a save is a
+ * single inflate and no copies. Without one, each file is copied out.
+ */
+int ConsoleParser::parseListing(const Data &dataIn, const editor::FileSlab& theSlab) {
     DataManager managerIn(dataIn, consoleIsBigEndian(myConsole));
 
     c_u32 indexOffset = managerIn.readInt32();
@@ -31,81 +302,98 @@ int ConsoleParser::readListing(const Data &dataIn) {
         }
         totalSize += fileSize;
 
+        if (static_cast<u64>(index) + fileSize > dataIn.size) {
+            return printf_err(INVALID_SAVE, "file '%s' goes outside the listing\n", fileName.c_str());
+        }
+
+        // unwanted files are never copied, or even touched
+        const lce::FILETYPE fileType = getFileTypeFromName(fileName);
+        if (!myListingPtr->myReadSettings.wantsFileType(fileType)) {
+            myListingPtr->myReadSettings.setIsPartial(true);
+            continue;
+        }
         managerIn.seek(index);
-        u8* data = managerIn.readBytes(fileSize);
 
         // TODO: make sure all files are set with the correct console
-        myListingPtr->myAllFiles.emplace_back(myConsole, data, fileSize, timestamp);
+        if (theSlab != nullptr) {
+            myListingPtr->myAllFiles.emplace_back(myConsole, managerIn.ptr, fileSize, timestamp, theSlab);
+        } else {
+            myListingPtr->myAllFiles.emplace_back(myConsole, managerIn.readBytes(fileSize), fileSize, timestamp);
+        }
         editor::LCEFile &file = myListingPtr->myAllFiles.back();
-
-        if (fileName.ends_with(".mcr")) {
-            if (fileName.starts_with("DIM-1")) {
-                file.fileType = lce::FILETYPE::REGION_NETHER;
-            } else if (fileName.starts_with("DIM1")) {
-                file.fileType = lce::FILETYPE::REGION_END;
-            } else if (fileName.starts_with("r")) {
-                file.fileType = lce::FILETYPE::REGION_OVERWORLD;
+        file.fileType = fileType;
+
+        switch (fileType) {
+            case lce::FILETYPE::REGION_NETHER:
+            case lce::FILETYPE::REGION_OVERWORLD:
+            case lce::FILETYPE::REGION_END: {
+                c_auto [fst, snd] = extractRegionCoords(fileName);
+                file.setRegionX(static_cast<i16>(fst));
+                file.setRegionZ(static_cast<i16>(snd));
+                break;
             }
-            c_auto [fst, snd] = extractRegionCoords(fileName);
-            file.setRegionX(static_cast<i16>(fst));
-            file.setRegionZ(static_cast<i16>(snd));
-
-        } else if (fileName == "entities.dat") {
-            file.fileType = lce::FILETYPE::ENTITY_OVERWORLD;
-
-
-        } else if (fileName.ends_with("entities.dat")) {
-            if (fileName.starts_with("DIM-1")) {
-                file.fileType = lce::FILETYPE::ENTITY_NETHER;
-            } else if (fileName.starts_with("DIM1/")) {
-                file.fileType = lce::FILETYPE::ENTITY_END;
+            case lce::FILETYPE::MAP: {
+                c_i16 mapNumber = extractMapNumber(fileName);
+                file.setMapNumber(mapNumber);
+                break;
             }
+            case lce::FILETYPE::STRUCTURE:
+            case lce::FILETYPE::GRF:
+            case lce::FILETYPE::PLAYER:
+                file.setFileName(fileName);
+                break;
+            default:
+                break;
+        }
 
-        } else if (fileName == "level.dat") {
-            file.fileType = lce::FILETYPE::LEVEL;
-
-        } else if (fileName.starts_with("data/map_")) {
-            file.fileType = lce::FILETYPE::MAP;
-            c_i16 mapNumber = extractMapNumber(fileName);
-            file.setMapNumber(mapNumber);
+    }
 
-        }else if (fileName == "data/villages.dat") {
-            file.fileType = lce::FILETYPE::VILLAGE;
+    myListingPtr->updatePointers();
+    printf("\n");
 
-        } else if (fileName == "data/largeMapDataMappings.dat") {
-            file.fileType = lce::FILETYPE::DATA_MAPPING;
+    return SUCCESS;
+}
 
-        } else if (fileName.starts_with("data/")) {
-            file.SetFileNameAndType(fileName, lce::FILETYPE::STRUCTURE);
 
-        } else if (fileName.ends_with(".grf")) {
-            file.SetFileNameAndType(fileName, lce::FILETYPE::GRF);
+/// PS4 and Switch keep each region in a file of its own next to the listing, see writeExternalFolder.
+static bool isWrittenExternally(const editor::LCEFile& theFile, const lce::CONSOLE consoleOut) {
+    return theFile.isRegionType() && (consoleOut == lce::CONSOLE::PS4 || consoleOut == lce::CONSOLE::SWITCH);
+}
 
-        } else if (fileName.starts_with("players/") ||
-                   fileName.find('/') == -1LLU) {
-            file.SetFileNameAndType(fileName, lce::FILETYPE::PLAYER);
 
-        } else {
-            printf("Unknown File: %s\n", fileName.c_str());
+u32 ConsoleParser::getListingSize(const lce::CONSOLE consoleOut) const {
+    u32 fileCount = 0;
+    u32 fileDataSize = 0;
+    for (const editor::LCEFile& file: myListingPtr->myAllFiles) {
+        if (isWrittenExternally(file, consoleOut)) {
+            continue;
         }
-
+        fileCount++;
+        fileDataSize += file.data.getSize();
     }
 
-    myListingPtr->updatePointers();
-    printf("\n");
+    u32 FOOTER_ENTRY_SIZE = 144;
+    if (myListingPtr->myReadSettings.getCurrentVersion() <= 1) {
+        FOOTER_ENTRY_SIZE = 136;
+    }
 
-    return SUCCESS;
+    return FILELISTING_HEADER_SIZE + fileDataSize + FOOTER_ENTRY_SIZE * fileCount;
 }
 
 
-Data ConsoleParser::writeListing(const lce::CONSOLE consoleOut) const {
+int ConsoleParser::writeListing(const lce::CONSOLE consoleOut, const ListingSink& theSink) const {
+    int status;
 
     // step 1: get the file count and size of all sub-files
-    c_u32 fileCount = myListingPtr->myAllFiles.size();
     c_i32 currentVersion = myListingPtr->myReadSettings.getCurrentVersion();
 
+    u32 fileCount = 0;
     u32 fileDataSize = 0;
     for (const editor::LCEFile& file: myListingPtr->myAllFiles) {
+        if (isWrittenExternally(file, consoleOut)) {
+            continue;
+        }
+        fileCount++;
         fileDataSize += file.data.getSize();
     }
 
@@ -116,77 +404,153 @@ Data ConsoleParser::writeListing(const lce::CONSOLE consoleOut) const {
         FOOTER_ENTRY_SIZE = 136;
     }
 
-    // step 2: find total binary size and create its data buffer
-    c_u32 totalFileSize = fileInfoOffset + FOOTER_ENTRY_SIZE * fileCount;
-
-    Data dataOut;
-    dataOut.allocate(totalFileSize);
-    memset(dataOut.data, 0, dataOut.size);
-
-    DataManager managerOut(dataOut, consoleIsBigEndian(consoleOut));
-
-    // step 3: write start
-    managerOut.writeInt32(fileInfoOffset);
+    // step 2: write start
+    u8 header[FILELISTING_HEADER_SIZE];
+    DataManager managerHeader(header, FILELISTING_HEADER_SIZE);
+    managerHeader.isBig = consoleIsBigEndian(consoleOut);
+    managerHeader.writeInt32(fileInfoOffset);
     u32 innocuousVariableName = fileCount;
     if (currentVersion <= 1) {
         innocuousVariableName *= 136;
     }
-    managerOut.writeInt32(innocuousVariableName);
-    managerOut.writeInt16(myListingPtr->myReadSettings.getOldestVersion());
-    managerOut.writeInt16(currentVersion);
+    managerHeader.writeInt32(innocuousVariableName);
+    managerHeader.writeInt16(myListingPtr->myReadSettings.getOldestVersion());
+    managerHeader.writeInt16(currentVersion);
+    if ((status = theSink(header, FILELISTING_HEADER_SIZE)) != SUCCESS) {
+        return status;
+    }
 
-    // step 4: write each files data
+    // step 3: write each files data, straight from the file
     // I am using additionalData as the offset into the file its data is at
     u32 index = FILELISTING_HEADER_SIZE;
     for (editor::LCEFile& fileIter : myListingPtr->myAllFiles) {
+        if (isWrittenExternally(fileIter, consoleOut)) {
+            continue;
+        }
         fileIter.additionalData = index;
         index += fileIter.data.getSize();
-        managerOut.writeFile(fileIter);
+        if (fileIter.data.getSize() != 0
+            && (status = theSink(fileIter.data.start(), fileIter.data.getSize())) != SUCCESS) {
+            return status;
+        }
     }
 
-    // step 5: write file metadata
+    // step 4: write file metadata, it is only a few KB
+    c_u32 footerSize = FOOTER_ENTRY_SIZE * fileCount;
+    OutputBuffer bufferFooter(footerSize);
+    DataManager managerFooter = bufferFooter.view(footerSize);
+    managerFooter.isBig = consoleIsBigEndian(consoleOut);
     for (const editor::LCEFile& fileIter: myListingPtr->myAllFiles) {
+        if (isWrittenExternally(fileIter, consoleOut)) {
+            continue;
+        }
         // printf("%2u. (@%7u)[%7u] - %s\n", count + 1, fileIter
         // .additionalData, fileIter.size, fileIter.name.c_str());
         std::string fileIterName = fileIter.constructFileName(consoleOut,
                                                               myListingPtr->myReadSettings.getHasSepRegions());
-        managerOut.writeWStringFromString(fileIterName, WSTRING_SIZE);
-        managerOut.writeInt32(fileIter.data.getSize());
-        managerOut.writeInt32(fileIter.additionalData);
+        managerFooter.writeWStringFromString(fileIterName, WSTRING_SIZE);
+        managerFooter.writeInt32(fileIter.data.getSize());
+        managerFooter.writeInt32(fileIter.additionalData);
         if (currentVersion > 1) {
-            managerOut.writeInt64(fileIter.timestamp);
+            managerFooter.writeInt64(fileIter.timestamp);
         }
     }
+    if (footerSize != 0) {
+        return theSink(bufferFooter.data(), footerSize);
+    }
+    return SUCCESS;
+}
+
 
-    return dataOut;
+int ConsoleParser::writeListing(const lce::CONSOLE consoleOut, Data& dataOut) const {
+    // every byte gets written, so it is not zeroed first
+    OutputBuffer bufferOut(getListingSize(consoleOut));
+    c_int status = writeListing(consoleOut, [&bufferOut](c_u8* theData, c_u32 theSize) {
+        bufferOut.writeBytesUnchecked(theData, theSize);
+        return SUCCESS;
+    });
+    if (status != SUCCESS) {
+        return status;
+    }
+    Data released = bufferOut.release();
+    dataOut.steal(released);
+    return SUCCESS;
 }
 
 
-void ConsoleParser::readFileInfo() const {
-    fs::path filePath = myFilePath.parent_path();
-    fs::path cachePathVita = myFilePath.parent_path().parent_path();
-    cachePathVita /= "CACHE.BIN";
+/**
+ * The listing is fed to zlib as it is laid out, so neither the inflated nor
+ * the deflated save is ever whole in memory, only the compressor's blocks are.
+ * The size header is patched in at the end, from what was actually streamed:
+ * a big endian u64, or on PS4 and Switch, 4 zero bytes and a little endian u32.
+ */
+int ConsoleParser::writeListingDeflated(const lce::CONSOLE consoleOut, const fs::path& theFilePath,
+                                        u64& theDeflatedSize) const {
+    DeflateFileWriter writer;
+    int status = writer.open(theFilePath);
+    if (status != SUCCESS) {
+        return status;
+    }
+
+    u8 sizeHeader[8] = {};
+    if ((status = writer.writeRaw(sizeHeader, 8)) != SUCCESS) {
+        return printf_err(status, "failed to write savefile to \"%s\"\n", theFilePath.string().c_str());
+    }
+
+    status = writeListing(consoleOut, [&writer](c_u8* theData, c_u32 theSize) {
+        return writer.write(theData, theSize);
+    });
+    if (status != SUCCESS || (status = writer.finish()) != SUCCESS) {
+        return printf_err(status, "failed to compress fileListing\n");
+    }
+
+    if (consoleOut == lce::CONSOLE::PS4 || consoleOut == lce::CONSOLE::SWITCH) {
+        endian::store<Endian::Little, u32>(sizeHeader + 4, static_cast<u32>(writer.getInflatedSize()));
+    } else {
+        endian::store<Endian::Big, u64>(sizeHeader, writer.getInflatedSize());
+    }
+    if ((status = writer.patch(0, sizeHeader, 8)) != SUCCESS) {
+        return printf_err(status, "failed to write savefile to \"%s\"\n", theFilePath.string().c_str());
+    }
 
-    switch (myConsole) {
+    theDeflatedSize = writer.getDeflatedSize();
+    return writer.close();
+}
+
+
+fs::path ConsoleParser::getFileInfoPath(const lce::CONSOLE theConsole, const fs::path& theFilePath) {
+    fs::path filePath = theFilePath.parent_path();
+    switch (theConsole) {
         case lce::CONSOLE::PS3:
         case lce::CONSOLE::RPCS3:
         case lce::CONSOLE::PS4:
-            filePath /= "THUMB";
-            break;
+            return filePath / "THUMB";
         case lce::CONSOLE::VITA:
-            filePath /= "THUMBDATA.BIN";
-            break;
+            return filePath / "THUMBDATA.BIN";
         case lce::CONSOLE::WIIU:
         case lce::CONSOLE::SWITCH: {
-            filePath = myFilePath;
+            filePath = theFilePath;
             filePath += ".ext";
-            break;
+            return filePath;
         }
         case lce::CONSOLE::XBOX360:
-            goto XBOX360_SKIP_READING_FILEINFO;
         case lce::CONSOLE::NONE:
         default:
-            return;
+            return {};
+    }
+}
+
+
+void ConsoleParser::readFileInfo() const {
+    const fs::path filePath = getFileInfoPath(myConsole, myFilePath);
+    fs::path cachePathVita = myFilePath.parent_path().parent_path();
+    cachePathVita /= "CACHE.BIN";
+
+    if (myConsole == lce::CONSOLE::XBOX360) {
+        goto XBOX360_SKIP_READING_FILEINFO;
+    }
+    if (filePath.empty()) {
+        return;
     }
 
     if (fs::exists(filePath)) {
@@ -218,46 +582,39 @@ XBOX360_SKIP_READING_FILEINFO:
  * \return
  */
 int ConsoleParser::readExternalFolder(const fs::path& inDirPath) {
-    MU int fileIndex = -1;
     for (c_auto& file : fs::directory_iterator(inDirPath)) {
 
         // TODO: place non-used files in a cache?
         if (is_directory(file)) { continue; }
-        fileIndex++;
 
         // initiate filename and filepath
-        std::string filePathStr = file.path().string();
         std::string fileNameStr = file.path().filename().string();
+        // "GAMEDATA_" + dimension + x + z, and the 4 byte size in front of the data
+        if (fileNameStr.size() < 17 || file.file_size() < 4) { continue; }
 
-        // open the file
-        DataManager manager_in;
-        manager_in.setLittleEndian(); // all of newgen is little endian
-        manager_in.readFromFile(filePathStr);
-        c_u32 fileSize = manager_in.readInt32();
-
-        Data dat_out;
-        dat_out.allocate(fileSize);
-        const DataManager manager_out(dat_out);
-        RLE_NSX_OR_PS4_DECOMPRESS(manager_in.ptr, manager_in.size - 4,
-                                  manager_out.ptr, manager_out.size);
-
-        // manager_out.writeToFile("C:\\Users\\Jerrin\\CLionProjects\\LegacyEditor\\out\\" + a_filename);
-
-        // TODO: get timestamp from file itself / make one up
-        u32 timestamp = 0;
-        myListingPtr->myAllFiles.emplace_back(myListingPtr->myReadSettings.getConsole(), dat_out.data, fileSize, timestamp);
-        editor::LCEFile &lFile = myListingPtr->myAllFiles.back();
         static constexpr lce::FILETYPE REGION_DIMENSIONS[3] = {
                 lce::FILETYPE::REGION_OVERWORLD,
                 lce::FILETYPE::REGION_NETHER,
                 lce::FILETYPE::REGION_END
         };
+        lce::FILETYPE fileType = lce::FILETYPE::NONE;
         if (c_auto dimChar = static_cast<char>(static_cast<int>(fileNameStr.at(12)) - 48);
-            dimChar < 0 || dimChar > 2) {
-            lFile.fileType = lce::FILETYPE::NONE;
-        } else {
-            lFile.fileType = REGION_DIMENSIONS[static_cast<int>(static_cast<u8>(dimChar))];
+            dimChar >= 0 && dimChar <= 2) {
+            fileType = REGION_DIMENSIONS[static_cast<int>(static_cast<u8>(dimChar))];
         }
+        // unwanted files are not even registered
+        if (!myListingPtr->myReadSettings.wantsFileType(fileType)) {
+            myListingPtr->myReadSettings.setIsPartial(true);
+            continue;
+        }
+
+        // only registered here, the dimension and position are in its name
+        // TODO: get timestamp from file itself / make one up
+        u32 timestamp = 0;
+        myListingPtr->myAllFiles.emplace_back(myListingPtr->myReadSettings.getConsole(), nullptr, 0, timestamp);
+        editor::LCEFile &lFile = myListingPtr->myAllFiles.back();
+        lFile.setExternalSource(file.path());
+        lFile.fileType = fileType;
         c_i16 rX = static_cast<i8>(strtol(
                 fileNameStr.substr(13, 2).c_str(), nullptr, 16));
         c_i16 rZ = static_cast<i8>(strtol(
@@ -268,5 +625,116 @@ int ConsoleParser::readExternalFolder(const fs::path& inDirPath) {
 
     myListingPtr->updatePointers();
 
+    if (myListingPtr->myReadSettings.getLazyExternalFiles()) {
+        return SUCCESS;
+    }
+    return myListingPtr->loadExternalFiles();
+}
+
+
+/// "GAMEDATA_000" + dimension + x + z, the inverse of what readExternalFolder parses.
+static std::string getExternalFileName(const editor::LCEFile& theFile) {
+    u32 dimension = 0;
+    if (theFile.fileType == lce::FILETYPE::REGION_NETHER) {
+        dimension = 1;
+    } else if (theFile.fileType == lce::FILETYPE::REGION_END) {
+        dimension = 2;
+    }
+    char name[18];
+    snprintf(name, sizeof(name), "GAMEDATA_000%01u%02x%02x", dimension,
+             static_cast<u8>(theFile.getRegionX()), static_cast<u8>(theFile.getRegionZ()));
+    return name;
+}
+
+
+/// regions are compressed and written on this many threads, each taking every n'th one.
+static constexpr int EXTERNAL_WRITE_THREADS = 4;
+
+
+static int writeExternalFile(const editor::LCEFile& theFile, const fs::path& outDirPath) {
+    const fs::path filePath = outDirPath / getExternalFileName(theFile);
+
+    // never read, so its file is still exactly what it was
+    if (!theFile.isLoaded()) {
+        std::error_code error;
+        if (fs::equivalent(theFile.getExternalSource(), filePath, error)) {
+            return SUCCESS;
+        }
+        fs::copy_file(theFile.getExternalSource(), filePath, fs::copy_options::overwrite_existing, error);
+        return error ? printf_err(FILE_ERROR, "failed to write savefile to \"%s\"\n", filePath.string().c_str())
+                     : SUCCESS;
+    }
+
+    Data dataOut;
+    dataOut.setScopeDealloc(true);
+    c_u32 maxSize = 4 + RLE_NSXPS4_COMPRESS_BOUND(theFile.data.size);
+    if (!dataOut.allocate(maxSize)) {
+        return printf_err(MALLOC_FAILED, ERROR_1, maxSize);
+    }
+    DataManager managerOut(dataOut, false); // all of newgen is little endian
+    managerOut.writeInt32(theFile.data.size);
+    c_u32 compressedSize = RLE_NSXPS4_COMPRESS(theFile.data.data, theFile.data.size,
+                                               managerOut.ptr, maxSize - 4);
+    if (compressedSize == 0 && theFile.data.size != 0) {
+        return printf_err(COMPRESS, "failed to compress \"%s\"\n", filePath.string().c_str());
+    }
+    managerOut.size = 4 + compressedSize;
+
+    // a region that came out the same as what is there is not rewritten
+    std::error_code error;
+    if (fs::file_size(filePath, error) == managerOut.size && !error) {
+        MappedFile fileOld;
+        if (fileOld.open(filePath) == SUCCESS
+            && std::memcmp(fileOld.data(), managerOut.data, managerOut.size) == 0) {
+            return SUCCESS;
+        }
+    }
+
+    return managerOut.writeToFile(filePath) == 0 ? SUCCESS : FILE_ERROR;
+}
+
+
+int ConsoleParser::writeExternalFolder(const fs::path& outDirPath) const {
+    std::vector<editor::LCEFile*> regions;
+    for (editor::LCEFile& file : myListingPtr->myAllFiles) {
+        if (file.isRegionType()) {
+            regions.push_back(&file);
+        }
+    }
+
+    std::error_code error;
+    fs::create_directories(outDirPath, error);
+    if (error) {
+        return printf_err(FILE_ERROR, "failed to create \"%s\"\n", outDirPath.string().c_str());
+    }
+
+    // each region is its own file, so they are compressed and written side by side
+    std::atomic<int> status = SUCCESS;
+    run_parallel<EXTERNAL_WRITE_THREADS>(std::function<void(int)>([&regions, &outDirPath, &status](c_int theThread) {
+        for (size_t index = theThread; index < regions.size(); index += EXTERNAL_WRITE_THREADS) {
+            if (c_int fileStatus = writeExternalFile(*regions[index], outDirPath); fileStatus != SUCCESS) {
+                status = fileStatus;
+            }
+        }
+    }));
+    if (status != SUCCESS) {
+        return status;
+    }
+
+    // regions a folder written before still holds, but that are not in the listing anymore
+    std::set<std::string> names;
+    for (const editor::LCEFile* region : regions) {
+        names.insert(getExternalFileName(*region));
+    }
+    for (c_auto& file : fs::directory_iterator(outDirPath, error)) {
+        std::string fileNameStr = file.path().filename().string();
+        if (file.is_directory(error) || fileNameStr.size() != 17 || fileNameStr.rfind("GAMEDATA_", 0) != 0
+            || names.contains(fileNameStr)) {
+            continue;
+        }
+        if (!fs::remove(file.path(), error)) {
+            return printf_err(FILE_ERROR, "failed to remove \"%s\"\n", file.path().string().c_str());
+        }
+    }
     return SUCCESS;
 }
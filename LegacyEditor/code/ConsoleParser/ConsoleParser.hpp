@@ -1,8 +1,12 @@
 #pragma once
 
+#include <functional>
+
 #include "LegacyEditor/code/FileListing/fileListing.hpp"
+#include "LegacyEditor/code/LCEFile/LCEFile.hpp"
 #include "LegacyEditor/utils/RLE/rle_nsxps4.hpp"
 #include "LegacyEditor/utils/dataManager.hpp"
+#include "LegacyEditor/utils/mappedFile.hpp"
 
 #include "headerUnion.hpp"
 
@@ -24,21 +28,59 @@ public:
     ND virtual int read(editor::FileListing* theListing, const fs::path& inFilePath) = 0;
     ND virtual int write(editor::FileListing* theListing, editor::WriteSettings& theSettings) const = 0;
 
+    /// THUMB / THUMBDATA.BIN / .ext next to theFilePath, empty for consoles without one.
+    ND static fs::path getFileInfoPath(lce::CONSOLE theConsole, const fs::path& theFilePath);
+
+private:
+    /// set by readCachedListing when there is a cache to have, so readListing only writes one then.
+    bool myIsListingCacheMissed = false;
+
+    ND int parseListing(const Data &dataIn, const editor::FileSlab& theSlab);
+
+    /// where myFilePath's listing is cached, empty if caching is off.
+    ND fs::path getListingCachePath() const;
+    /// a failed write only makes the next read slower, so readListing ignores it.
+    int writeCachedListing(const Data &dataIn) const;
+
 protected:
     mutable editor::FileListing* myListingPtr;
 
     ND virtual int inflateListing() = 0;
-    ND virtual int deflateListing(const fs::path& gameDataPath, Data& inflatedData, Data& deflatedData) const = 0;
 
 
-    ND int readListing(const Data &dataIn);
-    ND Data writeListing(lce::CONSOLE consoleOut) const;
+    /// the listing's mapping of myFilePath, opened here if findConsole didn't.
+    ND MappedFile* getInputFile() const;
+
+    /**
+     * Parses the listing out of the listing cache, if it has one for myFilePath
+     * as it is now. Inflating parsers try this before inflating.
+     * @return true if the listing was read.
+     */
+    ND bool readCachedListing();
+    /// the files borrow from dataIn, which the listing takes over as their slab. It is cached after a miss.
+    ND int readListing(Data &dataIn);
+    /// dataIn stays the caller's, so every file is copied out of it.
+    ND int readListingCopy(const Data &dataIn);
+
+    /// receives the listing piece by piece, in order. Anything but SUCCESS stops the write.
+    using ListingSink = std::function<int(c_u8* theData, u32 theSize)>;
+    /// the size of the inflated listing writeListing produces.
+    ND u32 getListingSize(lce::CONSOLE consoleOut) const;
+    /// hands the header, each file's data (not copied) and the footer to theSink.
+    /// PS4 and Switch regions are left out, writeExternalFolder writes those.
+    ND int writeListing(lce::CONSOLE consoleOut, const ListingSink& theSink) const;
+    /// the same, into dataOut. dataOut is only set on SUCCESS.
+    ND int writeListing(lce::CONSOLE consoleOut, Data& dataOut) const;
+    /// streams the listing into a zlib stream on disk, behind the console's header of its inflated size.
+    ND int writeListingDeflated(lce::CONSOLE consoleOut, const fs::path& theFilePath, u64& theDeflatedSize) const;
 
     void readFileInfo() const;
     // writeFileInfo...
 
     /// This function is used by Switch and PS4.
     int readExternalFolder(const fs::path& inDirPath);
-    // writeExternalFolder...
+    /// This function is used by Switch and PS4, regions that are already there unchanged are not rewritten,
+    /// and regions that are there but not in the listing are removed.
+    ND int writeExternalFolder(const fs::path& outDirPath) const;
 
 };
@@ -54,43 +54,30 @@ namespace editor {
         /// TODO: figure out if this comment is actually important or not
         /// TODO: check from regionFile chunk what console it is if uncompressed
         int inflateListing() override {
+            if (readCachedListing()) {
+                return SUCCESS;
+            }
+
             Data data;
             data.setScopeDealloc(true);
 
-            FILE *f_in = fopen(myFilePath.string().c_str(), "rb");
-            if (f_in == nullptr) {
-                return printf_err(FILE_ERROR, ERROR_4, myFilePath.string().c_str());
+            const MappedFile* fileIn = getInputFile();
+            if (fileIn == nullptr) {
+                return FILE_ERROR;
             }
-
-            fseek(f_in, 0, SEEK_END);
-            u64 input_size = ftell(f_in);
-            fseek(f_in, 0, SEEK_SET);
-            if (input_size < 12) {
-                fclose(f_in);
+            if (fileIn->size() < 12) {
                 return printf_err(FILE_ERROR, ERROR_5);
             }
             HeaderUnion headerUnion{};
-            fread(&headerUnion, 1, 12, f_in);
+            std::memcpy(&headerUnion, fileIn->data(), 12);
 
             u32 final_size = headerUnion.getDestSize();
             if(!data.allocate(final_size)) {
-                fclose(f_in);
                 return printf_err(MALLOC_FAILED, ERROR_1, final_size);
             }
 
-            input_size -= 12;
-            Data src;
-            src.setScopeDealloc(true);
-            if(!src.allocate(input_size)) {
-                fclose(f_in);
-                return printf_err(MALLOC_FAILED, ERROR_1, input_size);
-            }
-
-            fseek(f_in, 12, SEEK_SET);
-            fread(src.start(), 1, src.size, f_in);
-            fclose(f_in);
-
-            tinf_uncompress(data.start(), &final_size, src.start(), src.getSize());
+            // inflated straight out of the mapping
+            tinf_uncompress(data.start(), &final_size, fileIn->data() + 12, fileIn->size() - 12);
             if (final_size == 0) {
                 return printf_err(DECOMPRESS, "%s", ERROR_3);
             }
@@ -158,7 +145,11 @@ namespace editor {
 
             // GAMEDATA
             fs::path gameDataPath = rootPath / "GAMEDATA";
-            Data inflatedData = ConsoleParser::writeListing(myConsole);
+            Data inflatedData;
+            inflatedData.setScopeDealloc(true);
+            status = ConsoleParser::writeListing(myConsole, inflatedData);
+            if (status != 0) return printf_err(status,
+                "failed to write fileListing\n");
             Data deflatedData;
             deflatedData.setScopeDealloc(true);
             status = deflateListing(gameDataPath, inflatedData, deflatedData);
@@ -213,7 +204,7 @@ namespace editor {
         }
 
 
-        ND int deflateListing(MU const fs::path& gameDataPath, MU Data& inflatedData, MU Data& deflatedData) const override {
+        ND int deflateListing(MU const fs::path& gameDataPath, MU Data& inflatedData, MU Data& deflatedData) const {
 
             MU uLong deflatedSize = compressBound(static_cast<uLong>(inflatedData.size));
 
@@ -44,48 +44,37 @@ namespace editor {
 
 
         int inflateListing() override {
+            if (readCachedListing()) {
+                return SUCCESS;
+            }
+
             Data data;
             data.setScopeDealloc(true);
 
-            FILE *f_in = fopen(myFilePath.string().c_str(), "rb");
-            if (f_in == nullptr) {
-                return printf_err(FILE_ERROR, ERROR_4, myFilePath.string().c_str());
+            MappedFile* fileIn = getInputFile();
+            if (fileIn == nullptr) {
+                return FILE_ERROR;
             }
-
-            fseek(f_in, 0, SEEK_END);
-            u64 input_size = ftell(f_in);
-            fseek(f_in, 0, SEEK_SET);
-            if (input_size < 12) {
-                fclose(f_in);
+            if (fileIn->size() < 12) {
                 return printf_err(FILE_ERROR, ERROR_5);
             }
             HeaderUnion headerUnion{};
-            fread(&headerUnion, 1, 12, f_in);
+            std::memcpy(&headerUnion, fileIn->data(), 12);
 
             u32 final_size = headerUnion.getInt2Swap();
             if(!data.allocate(final_size)) {
-                fclose(f_in);
                 return printf_err(MALLOC_FAILED, ERROR_1, final_size);
             }
 
-            input_size -= 8;
-            Data src;
-            src.setScopeDealloc(true);
-            if(!src.allocate(input_size)) {
-                fclose(f_in);
-                return printf_err(MALLOC_FAILED, ERROR_1, input_size);
-            }
-
-            fseek(f_in, 8, SEEK_SET);
-            fread(src.start(), 1, input_size, f_in);
-            fclose(f_in);
-
-            int status = tinf_zlib_uncompress(data.start(), &data.size, src.start(), input_size);
+            // inflated straight out of the mapping, while the pages ahead of it are read in
+            fileIn->prefetch(8);
+            int status = tinf_zlib_uncompress(data.start(), &data.size, fileIn->data() + 8, fileIn->size() - 8);
+            fileIn->stopPrefetch();
             if (status != 0) {
                 return DECOMPRESS;
             }
 
-            status = readListing(data);
+            status = ConsoleParser::readListing(data);
             if (status != 0) {
                 return -1;
             }
@@ -97,7 +86,11 @@ namespace editor {
         int readExternalFiles() {
             auto folders = findExternalFolder();
             int status;
+            myExternalFolders.clear();
             for (c_auto& folder : folders) {
+                if (!folder.empty()) {
+                    myExternalFolders.push_back(folder);
+                }
                 status = readExternalFolder(folder);
                 if (status != 0) {
                     printf("Failed to read associated external files.\n");
@@ -109,16 +102,58 @@ namespace editor {
         }
 
 
-        ND int write(MU editor::FileListing* theListing, MU editor::WriteSettings& theSettings) const override {
+        /**
+         * Writes "root/0000000X/savedata0" and the region folder "root/0000000Y/savedata0",
+         * named after and with the sce_sys of the folders the save was read from.
+         * Those are made by the console, so only a save read as PS4 can be written as one.
+         * Regions read from more than one folder all go to the first.
+         */
+        ND int write(editor::FileListing* theListing, editor::WriteSettings& theSettings) const override {
+            int status;
+
             myListingPtr = theListing;
+            if (myListingPtr->myReadSettings.getConsole() != myConsole || myExternalFolders.empty()) {
+                return printf_err(NOT_IMPLEMENTED,
+                    "PS4.write(): only a PS4 save with its region folder can be written as PS4\n");
+            }
+            const fs::path rootPath = theSettings.getInFolderPath();
 
-            printf("PS4.write(): not implemented!\n");
-            return NOT_IMPLEMENTED;
-        }
 
+            // GAMEDATA
+            const fs::path mainDirPath = myFilePath.parent_path();
+            const fs::path outMainDirPath = rootPath / mainDirPath.parent_path().filename() / "savedata0";
+            if ((status = copySystemFolder(mainDirPath, outMainDirPath)) != SUCCESS) {
+                return status;
+            }
+
+            const fs::path gameDataPath = outMainDirPath / "GAMEDATA";
+            u64 deflatedSize = 0;
+            status = ConsoleParser::writeListingDeflated(myConsole, gameDataPath, deflatedSize);
+            if (status != 0)
+                return printf_err(status, "failed to compress fileListing\n");
+            theSettings.setOutFilePath(gameDataPath);
+            printf("gamedata final size: %llu\n", static_cast<unsigned long long>(deflatedSize));
+
+
+            // FILE INFO
+            const fs::path fileInfoPath = getFileInfoPath(myConsole, gameDataPath);
+
+            Data fileInfoData = myListingPtr->fileInfo.writeFile(fileInfoPath, myConsole);
+            fileInfoData.setScopeDealloc(true);
 
-        ND int deflateListing(MU const fs::path& gameDataPath, MU Data& inflatedData, MU Data& deflatedData) const override {
-            return NOT_IMPLEMENTED;
+            status = DataManager(fileInfoData).writeToFile(fileInfoPath);
+            if (status != 0) return printf_err(status,
+                "failed to write fileInfo to \"%s\"\n",
+                fileInfoPath.string().c_str());
+
+
+            // REGIONS
+            const fs::path& regionDirPath = myExternalFolders.front();
+            const fs::path outRegionDirPath = rootPath / regionDirPath.parent_path().filename() / "savedata0";
+            if ((status = copySystemFolder(regionDirPath, outRegionDirPath)) != SUCCESS) {
+                return status;
+            }
+            return writeExternalFolder(outRegionDirPath);
         }
 
 
@@ -196,11 +231,24 @@ namespace editor {
         }
 
 
-        MU static int writeExternalFolder(MU const fs::path& outDirPath) {
-            return NOT_IMPLEMENTED;
-        }
+    private:
+        /// the "root/0000000Y/savedata0" folders the regions were read from.
+        std::vector<fs::path> myExternalFolders;
 
 
+        /// a "savedata0" folder's sce_sys is the console's, so it is only ever copied over.
+        static int copySystemFolder(const fs::path& inDirPath, const fs::path& outDirPath) {
+            std::error_code error;
+            fs::create_directories(outDirPath / "sce_sys", error);
+            if (!error && !fs::equivalent(inDirPath, outDirPath, error)) {
+                fs::copy(inDirPath / "sce_sys", outDirPath / "sce_sys",
+                         fs::copy_options::recursive | fs::copy_options::overwrite_existing, error);
+            }
+            if (error) {
+                return printf_err(FILE_ERROR, "failed to copy \"%s\"\n", (inDirPath / "sce_sys").string().c_str());
+            }
+            return SUCCESS;
+        }
     };
 }
 
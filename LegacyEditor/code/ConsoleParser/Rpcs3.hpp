@@ -48,34 +48,16 @@ namespace editor {
 
 
         int inflateListing() override {
-            Data data;
-            data.setScopeDealloc(true);
-
-            FILE *f_in = fopen(myFilePath.string().c_str(), "rb");
-            if (f_in == nullptr) {
-                return printf_err(FILE_ERROR, ERROR_4, myFilePath.string().c_str());
+            const MappedFile* fileIn = getInputFile();
+            if (fileIn == nullptr) {
+                return FILE_ERROR;
             }
-
-            fseek(f_in, 0, SEEK_END);
-            c_u64 input_size = ftell(f_in);
-            fseek(f_in, 0, SEEK_SET);
-            if (input_size < 12) {
-                fclose(f_in);
+            if (fileIn->size() < 12) {
                 return printf_err(FILE_ERROR, ERROR_5);
             }
-            HeaderUnion headerUnion{};
-            fread(&headerUnion, 1, 12, f_in);
-
-            if(!data.allocate(input_size)) {
-                fclose(f_in);
-                return printf_err(MALLOC_FAILED, ERROR_1, input_size);
-            }
-
-            fseek(f_in, 0, SEEK_SET);
-            fread(data.start(), 1, data.size, f_in);
-            fclose(f_in);
 
-            int status = readListing(data);
+            // it is not compressed, so the files are copied straight out of the mapping
+            int status = readListingCopy(fileIn->view());
             if (status != 0) {
                 return -1;
             }
@@ -139,8 +121,11 @@ namespace editor {
 
             // GAMEDATA
             fs::path gameDataPath = rootPath / "GAMEDATA";
-            Data inflatedData = writeListing(myConsole);
+            Data inflatedData;
             inflatedData.setScopeDealloc(true);
+            status = writeListing(myConsole, inflatedData);
+            if (status != 0) return printf_err(status,
+                "failed to write fileListing\n");
             Data deflatedData;
             deflatedData.setScopeDealloc(true);
             status = deflateListing(gameDataPath, inflatedData, deflatedData);
@@ -199,7 +184,7 @@ namespace editor {
         }
 
 
-        ND int deflateListing(const fs::path& gameDataPath, Data& inflatedData, MU Data& deflatedData) const override {
+        ND int deflateListing(const fs::path& gameDataPath, Data& inflatedData, MU Data& deflatedData) const {
             deflatedData.steal(inflatedData);
 
             // file operations
@@ -43,43 +43,32 @@ namespace editor {
 
 
         int inflateListing() override {
+            if (readCachedListing()) {
+                return SUCCESS;
+            }
+
             Data data;
             data.setScopeDealloc(true);
 
-            FILE *f_in = fopen(myFilePath.string().c_str(), "rb");
-            if (f_in == nullptr) {
-                return printf_err(FILE_ERROR, ERROR_4, myFilePath.string().c_str());
+            MappedFile* fileIn = getInputFile();
+            if (fileIn == nullptr) {
+                return FILE_ERROR;
             }
-
-            fseek(f_in, 0, SEEK_END);
-            u64 input_size = ftell(f_in);
-            fseek(f_in, 0, SEEK_SET);
-            if (input_size < 12) {
-                fclose(f_in);
+            if (fileIn->size() < 12) {
                 return printf_err(FILE_ERROR, ERROR_5);
             }
             HeaderUnion headerUnion{};
-            fread(&headerUnion, 1, 12, f_in);
+            std::memcpy(&headerUnion, fileIn->data(), 12);
 
             u32 final_size = headerUnion.getInt2Swap();
             if(!data.allocate(final_size)) {
-                fclose(f_in);
                 return printf_err(MALLOC_FAILED, ERROR_1, final_size);
             }
 
-            input_size -= 8;
-            Data src;
-            src.setScopeDealloc(true);
-            if(!src.allocate(input_size)) {
-                fclose(f_in);
-                return printf_err(MALLOC_FAILED, ERROR_1, input_size);
-            }
-
-            fseek(f_in, 8, SEEK_SET);
-            fread(src.start(), 1, input_size, f_in);
-            fclose(f_in);
-
-            int status = tinf_zlib_uncompress(data.start(), &data.size, src.start(), input_size);
+            // inflated straight out of the mapping, while the pages ahead of it are read in
+            fileIn->prefetch(8);
+            int status = tinf_zlib_uncompress(data.start(), &data.size, fileIn->data() + 8, fileIn->size() - 8);
+            fileIn->stopPrefetch();
             if (status != 0) {
                 return DECOMPRESS;
             }
@@ -110,22 +99,39 @@ namespace editor {
         }
 
 
-        ND int write(MU editor::FileListing* theListing, MU editor::WriteSettings& theSettings) const override {
+        ND int write(editor::FileListing* theListing, editor::WriteSettings& theSettings) const override {
+            int status;
+
             myListingPtr = theListing;
+            const fs::path rootPath = theSettings.getInFolderPath();
 
-            printf("Switch.write(): not implemented!\n");
-            return NOT_IMPLEMENTED;
-        }
 
+            // GAMEDATA
+            const fs::path gameDataPath = rootPath / getCurrentDateTimeString();
+            u64 deflatedSize = 0;
+            status = ConsoleParser::writeListingDeflated(myConsole, gameDataPath, deflatedSize);
+            if (status != 0)
+                return printf_err(status, "failed to compress fileListing\n");
+            theSettings.setOutFilePath(gameDataPath);
+            printf("gamedata final size: %llu\n", static_cast<unsigned long long>(deflatedSize));
 
-        ND int deflateListing(MU const fs::path& gameDataPath, MU Data& inflatedData, MU Data& deflatedData) const override {
-            return NOT_IMPLEMENTED;
-        }
+
+            // FILE INFO
+            const fs::path fileInfoPath = getFileInfoPath(myConsole, gameDataPath);
+
+            Data fileInfoData = myListingPtr->fileInfo.writeFile(fileInfoPath, myConsole);
+            fileInfoData.setScopeDealloc(true);
+
+            status = DataManager(fileInfoData).writeToFile(fileInfoPath);
+            if (status != 0) return printf_err(status,
+                "failed to write fileInfo to \"%s\"\n",
+                fileInfoPath.string().c_str());
 
 
-        MU static int writeExternalFolder(MU const fs::path& outDirPath) {
-            printf("FileListing::writeExternalFolder: not implemented!");
-            return NOT_IMPLEMENTED;
+            // REGIONS, in the ".sub" folder readExternalFiles looks for
+            fs::path regionDirPath = gameDataPath;
+            regionDirPath.replace_extension(".sub");
+            return writeExternalFolder(regionDirPath);
         }
     };
 }
@@ -44,44 +44,30 @@ namespace editor {
 
 
         int inflateListing() override {
+            if (readCachedListing()) {
+                return SUCCESS;
+            }
+
             Data data;
             data.setScopeDealloc(true);
 
-            FILE *f_in = fopen(myFilePath.string().c_str(), "rb");
-            if (f_in == nullptr) {
-                return printf_err(FILE_ERROR, ERROR_4, myFilePath.string().c_str());
+            const MappedFile* fileIn = getInputFile();
+            if (fileIn == nullptr) {
+                return FILE_ERROR;
             }
-
-            fseek(f_in, 0, SEEK_END);
-            u64 input_size = ftell(f_in);
-            fseek(f_in, 0, SEEK_SET);
-            if (input_size < 12) {
-                fclose(f_in);
+            if (fileIn->size() < 12) {
                 return printf_err(FILE_ERROR, ERROR_5);
             }
             HeaderUnion headerUnion{};
-            fread(&headerUnion, 1, 12, f_in);
+            std::memcpy(&headerUnion, fileIn->data(), 12);
 
             u32 final_size = headerUnion.getDestSize();
             if(!data.allocate(final_size)) {
-                fclose(f_in);
                 return printf_err(MALLOC_FAILED, ERROR_1, final_size);
             }
 
-            input_size -= 8;
-            Data src;
-            src.setScopeDealloc(true);
-            if(!src.allocate(input_size)) {
-                fclose(f_in);
-                return printf_err(MALLOC_FAILED, ERROR_1, input_size);
-            }
-
-            // goto offset 8 for the data, read data into src
-            fseek(f_in, 8, SEEK_SET);
-            fread(src.data, 1, input_size, f_in);
-            fclose(f_in);
-
-            RLEVITA_DECOMPRESS(src.data, src.size, data.data, data.size);
+            // the data starts at offset 8, decompressed straight out of the mapping
+            RLEVITA_DECOMPRESS(fileIn->data() + 8, fileIn->size() - 8, data.data, data.size);
 
             int status = ConsoleParser::readListing(data);
             if (status != 0) {
@@ -109,8 +95,11 @@ namespace editor {
 
             // GAMEDATA
             fs::path gameDataPath = rootPath / "GAMEDATA.bin";
-            Data deflatedData = ConsoleParser::writeListing(myConsole);
+            Data deflatedData;
             deflatedData.setScopeDealloc(true);
+            status = ConsoleParser::writeListing(myConsole, deflatedData);
+            if (status != 0) return printf_err(status,
+                "failed to write fileListing\n");
             Data inflatedData;
             inflatedData.setScopeDealloc(true);
             status = deflateListing(gameDataPath, deflatedData, inflatedData);
@@ -134,7 +123,7 @@ namespace editor {
         }
 
 
-        ND int deflateListing(const fs::path& gameDataPath, Data& inflatedData, MU Data& deflatedData) const override {
+        ND int deflateListing(const fs::path& gameDataPath, Data& inflatedData, MU Data& deflatedData) const {
             deflatedData.allocate(inflatedData.size + 2);
 
             deflatedData.size = RLEVITA_COMPRESS(
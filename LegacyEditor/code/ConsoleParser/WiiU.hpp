@@ -44,51 +44,36 @@ namespace editor {
 
 
         int inflateListing() override {
+            if (readCachedListing()) {
+                return SUCCESS;
+            }
+
             Data data;
             data.setScopeDealloc(true);
 
-            FILE *f_in = fopen(myFilePath.string().c_str(), "rb");
-            if (f_in == nullptr) {
-                return printf_err(FILE_ERROR, ERROR_4, myFilePath.string().c_str());
+            MappedFile* fileIn = getInputFile();
+            if (fileIn == nullptr) {
+                return FILE_ERROR;
             }
-
-            fseek(f_in, 0, SEEK_END);
-            u64 input_size = ftell(f_in);
-            fseek(f_in, 0, SEEK_SET);
-            if (input_size < 12) {
-                fclose(f_in);
+            if (fileIn->size() < 12) {
                 return printf_err(FILE_ERROR, ERROR_5);
             }
             HeaderUnion headerUnion{};
-            fread(&headerUnion, 1, 12, f_in);
+            std::memcpy(&headerUnion, fileIn->data(), 12);
 
             u32 final_size = headerUnion.getDestSize();
             if(!data.allocate(final_size)) {
-                fclose(f_in);
                 return printf_err(MALLOC_FAILED, ERROR_1, final_size);
             }
 
-            input_size -= 8;
-            Data src;
-            src.setScopeDealloc(true);
-            if(!src.allocate(input_size * 2)) { // why is the x2 here?
-                fclose(f_in);
-                return printf_err(MALLOC_FAILED, ERROR_1, input_size * 2); // why is the x2 here?
-            }
-
-            fseek(f_in, 8, SEEK_SET);
-            fread(src.start(), 1, input_size, f_in);
-            fclose(f_in);
-
-            int status = tinf_zlib_uncompress(data.start(), &data.size, src.start(), input_size);
+            // inflated straight out of the mapping, while the pages ahead of it are read in
+            fileIn->prefetch(8);
+            int status = tinf_zlib_uncompress(data.start(), &data.size, fileIn->data() + 8, fileIn->size() - 8);
+            fileIn->stopPrefetch();
             if (status != 0) {
                 return DECOMPRESS;
             }
 
-
-            // std::string loc = R"(C:\Users\jerrin\Desktop\New folder\OUT\WiiU)";
-            // DataManager(data).writeToFile(loc);
-
             status = ConsoleParser::readListing(data);
             if (status != 0) {
                 return -1;
@@ -107,15 +92,12 @@ namespace editor {
 
             // GAMEDATA
             fs::path gameDataPath = rootPath / getCurrentDateTimeString();
-            Data inflatedData = ConsoleParser::writeListing(myConsole);
-            inflatedData.setScopeDealloc(true);
-            Data deflatedData;
-            deflatedData.setScopeDealloc(true);
-            status = deflateListing(gameDataPath, inflatedData, deflatedData);
+            u64 deflatedSize = 0;
+            status = ConsoleParser::writeListingDeflated(myConsole, gameDataPath, deflatedSize);
             if (status != 0)
                 return printf_err(status, "failed to compress fileListing\n");
             theSettings.setOutFilePath(gameDataPath);
-            printf("gamedata final size: %u\n", deflatedData.size);
+            printf("gamedata final size: %llu\n", static_cast<unsigned long long>(deflatedSize));
 
 
             // FILE INFO
@@ -134,30 +116,6 @@ namespace editor {
         }
 
 
-        ND int deflateListing(const fs::path& gameDataPath, Data& inflatedData, MU Data& deflatedData) const override {
-            deflatedData.allocate(compressBound(inflatedData.size));
-
-            if (compress(deflatedData.data, reinterpret_cast<uLongf*>(&deflatedData.size),
-                         inflatedData.data, inflatedData.size) != Z_OK) {
-                return COMPRESS;
-            }
-
-            // file operations
-            FILE *f_out = fopen(gameDataPath.string().c_str(), "wb");
-            if (f_out == nullptr) return printf_err(FILE_ERROR,
-                "failed to write savefile to \"%s\"\n",
-                gameDataPath.string().c_str());
-            uint64_t sizeToWrite = inflatedData.size;
-            if (isSystemLittleEndian())
-                sizeToWrite = swapEndian64(sizeToWrite);
-            fwrite(&sizeToWrite, 8, 1, f_out);
-            fwrite(deflatedData.data, 1, deflatedData.size, f_out);
-            fclose(f_out);
-
-            return SUCCESS;
-        }
-
-
     };
 
 
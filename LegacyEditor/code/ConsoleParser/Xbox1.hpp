@@ -51,11 +51,6 @@ namespace editor {
         }
 
 
-        ND int deflateListing(MU const fs::path& gameDataPath, MU Data& inflatedData, MU Data& deflatedData) const override {
-            return NOT_IMPLEMENTED;
-        }
-
-
     };
 
 
@@ -35,34 +35,22 @@ namespace editor {
             myListingPtr = theListing;
             myFilePath = theFilePath;
 
-            FILE *f_in = fopen(myFilePath.string().c_str(), "rb");
-            if (f_in == nullptr) {
-                return printf_err(FILE_ERROR, ERROR_4, myFilePath.string().c_str());
+            // the STFS package is parsed straight out of the mapping
+            const MappedFile* fileIn = getInputFile();
+            if (fileIn == nullptr) {
+                return FILE_ERROR;
             }
-
-            fseek(f_in, 0, SEEK_END);
-            c_u64 input_size = ftell(f_in);
-            fseek(f_in, 0, SEEK_SET);
-            if (input_size < 12) {
+            if (fileIn->size() < 12) {
                 return printf_err(FILE_ERROR, ERROR_5);
             }
-            HeaderUnion headerUnion{};
-            fread(&headerUnion, 1, 12, f_in);
-
-            Data bin;
-            bin.allocate(input_size);
-
-            fseek(f_in, 0, SEEK_SET);
-            fread(bin.start(), 1, bin.size, f_in);
 
-            DataManager binFile(bin.data, bin.size);
+            DataManager binFile(fileIn->data(), fileIn->size());
             StfsPackage stfsInfo(binFile);
             stfsInfo.parse();
             StfsFileListing listing = stfsInfo.getFileListing();
 
             StfsFileEntry* entry = findSavegameFileEntry(listing);
             if (entry == nullptr) {
-                bin.deallocate();
                 return {};
             }
 
@@ -80,10 +68,6 @@ namespace editor {
             myListingPtr->fileInfo.baseSaveName = stfsInfo.getMetaData().displayName;
 
 
-
-
-            bin.deallocate();
-
             c_u32 srcSize = deflatedData.readInt32() - 8;
 
             Data data;
@@ -121,11 +105,6 @@ namespace editor {
         }
 
 
-        ND int deflateListing(MU const fs::path& gameDataPath, MU Data& inflatedData, MU Data& deflatedData) const override {
-            return NOT_IMPLEMENTED;
-        }
-
-
     };
 
 
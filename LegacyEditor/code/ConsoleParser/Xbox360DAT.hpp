@@ -46,44 +46,36 @@ namespace editor {
 
         // TODO: allocating memory from file_size, but then updating that size from XDecompress?
         int inflateListing() override {
+            if (readCachedListing()) {
+                return SUCCESS;
+            }
+
             Data inflatedData;
             inflatedData.setScopeDealloc(true);
 
-            FILE *f_in = fopen(myFilePath.string().c_str(), "rb");
-            if (f_in == nullptr) {
-                return printf_err(FILE_ERROR, ERROR_4, myFilePath.string().c_str());
+            const MappedFile* fileIn = getInputFile();
+            if (fileIn == nullptr) {
+                return FILE_ERROR;
             }
-
-            fseek(f_in, 0, SEEK_END);
-            c_u64 input_size = ftell(f_in);
-            fseek(f_in, 0, SEEK_SET);
-            if (input_size < 12) {
-                fclose(f_in);
+            if (fileIn->size() < 12) {
                 return printf_err(FILE_ERROR, ERROR_5);
             }
             HeaderUnion headerUnion{};
-            fread(&headerUnion, 1, 12, f_in);
+            std::memcpy(&headerUnion, fileIn->data(), 12);
 
             c_u32 file_size = headerUnion.getInt3();
             if(!inflatedData.allocate(file_size)) {
-                fclose(f_in);
                 return printf_err(MALLOC_FAILED, ERROR_1, file_size);
             }
 
+            // needs to be authenticated
             c_u32 src_size = headerUnion.getInt1() - 8;
-            Data deflatedData;
-            deflatedData.setScopeDealloc(true);
-            if(!deflatedData.allocate(src_size)) {
-                fclose(f_in);
-                return printf_err(MALLOC_FAILED, ERROR_1, input_size);
+            if (src_size > fileIn->size() - 12) {
+                return printf_err(INVALID_SAVE, "%s", ERROR_3);
             }
 
-            fseek(f_in, 12, SEEK_SET); // needs to be authenticated
-            fread(deflatedData.start(), 1, deflatedData.size, f_in);
-            fclose(f_in);
-
             int error = XDecompress(inflatedData.start(), &inflatedData.size,
-                                    deflatedData.start(), deflatedData.getSize());
+                                    fileIn->data() + 12, src_size);
             if (error != 0) {
                 return printf_err(DECOMPRESS, "%s", ERROR_3);
             }
@@ -109,11 +101,6 @@ namespace editor {
         }
 
 
-        ND int deflateListing(MU const fs::path& gameDataPath, MU Data& inflatedData, MU Data& deflatedData) const override {
-            return NOT_IMPLEMENTED;
-        }
-
-
     };
 
 
@@ -6,6 +6,7 @@
 
 #include "LegacyEditor/utils/dataManager.hpp"
 #include "LegacyEditor/utils/error_status.hpp"
+#include "LegacyEditor/utils/mappedFile.hpp"
 #include "LegacyEditor/utils/utils.hpp"
 
 
@@ -138,8 +139,12 @@ namespace editor {
     // TODO: idk formatting of header for nintendo consoles
     int FileInfo::readFile(const fs::path& inFilePath, const lce::CONSOLE inConsole) {
         isLoaded = false;
-        DataManager manager;
-        manager.readFromFile(inFilePath.string());
+        // mapped, so nothing is left to free once the thumbnail is copied out
+        MappedFile fileIn;
+        if (fileIn.open(inFilePath) != SUCCESS || fileIn.size() < 8) {
+            return FILE_ERROR;
+        }
+        DataManager manager(fileIn.data(), fileIn.size());
 
         readHeader(manager, inConsole);
 
@@ -159,11 +164,13 @@ namespace editor {
      */
     int FileInfo::readCacheFile(const fs::path& inFilePath, MU const std::string& folderName) {
         isLoaded = false;
-        DataManager manager;
+        MappedFile fileIn;
+        if (fileIn.open(inFilePath) != SUCCESS) {
+            return FILE_ERROR;
+        }
+        DataManager manager(fileIn.data(), fileIn.size());
         manager.setLittleEndian();
 
-        manager.readFromFile(inFilePath.string());
-
         bool foundInfo = false;
         u32 pngOffset = 0;
         u16 filesFound = manager.readInt16();
@@ -1,6 +1,7 @@
 #include "fileListing.hpp"
 
 #include <cstdio>
+#include <cstring>
 
 #include "include/ghc/fs_std.hpp"
 
@@ -38,7 +39,14 @@ namespace editor {
 
 
     int FileListing::read(const fs::path& theFilePath) {
+        return read(theFilePath, {});
+    }
+
+
+    int FileListing::read(const fs::path& theFilePath, const std::set<lce::FILETYPE>& theFileTypes) {
         myReadSettings.setFilePath(theFilePath);
+        myReadSettings.setFileTypes(theFileTypes);
+        myReadSettings.setIsPartial(false);
 
         i32 status1 = findConsole(theFilePath);
         if (status1 != SUCCESS) {
@@ -47,6 +55,8 @@ namespace editor {
         }
 
         i32 status2 = readSave();
+        // every file has been copied out of it
+        mySourceFile.close();
         if (status2 != SUCCESS) {
             printf("Failed to read save from %s\n", theFilePath.string().c_str());
             return status2;
@@ -90,10 +100,19 @@ namespace editor {
             printf("Write Settings are not valid, exiting\n");
             return STATUS::INVALID_ARGUMENT;
         }
+        // the files it was read without would be missing from the output
+        if (myReadSettings.getIsPartial()) {
+            return printf_err(INVALID_ARGUMENT, "the save was read with only some of its file types, "
+                                                "it cannot be written\n");
+        }
 
         // TODO: create default output file path if not set
 
+        // writing to the console it was read from copies regions that were never loaded as they are
         if (myReadSettings.getConsole() != theWriteSettings.getConsole()) {
+            if (c_int status = loadExternalFiles(); status != SUCCESS) {
+                return status;
+            }
             if (theWriteSettings.shouldRemovePlayers) {
                 removeFileTypes({lce::FILETYPE::PLAYER});
             }
@@ -119,9 +138,18 @@ namespace editor {
             }
             removeFileTypes({lce::FILETYPE::STRUCTURE});
             removeFileTypes({lce::FILETYPE::GRF});
+        } else if (const fs::path cachePath = theWriteSettings.getConversionCachePath(); !cachePath.empty()) {
+            // a missing or outdated cache just starts out empty
+            ConversionCache cache;
+            if (std::error_code error; fs::exists(cachePath, error)) {
+                (void) cache.load(cachePath);
+            }
+            convertRegions(consoleOut, &cache);
+            if (cache.isChanged() && cache.save(cachePath) != SUCCESS) {
+                printf("failed to save the conversion cache to %s\n", cachePath.string().c_str());
+            }
         } else {
-            
-            convertRegions(theWriteSettings.getConsole());
+            convertRegions(consoleOut);
         }
 
 
@@ -135,36 +163,37 @@ namespace editor {
 
 
     int FileListing::findConsole(const fs::path& inFilePath) {
-        static constexpr uint32_t CON_MAGIC = 0x434F4E20;
-        static constexpr uint32_t ZLIB_MAGIC = 0x789C;
-
-
-        FILE* f_in = fopen(inFilePath.string().c_str(), "rb");
-        if (f_in == nullptr) {
-            return printf_err(FILE_ERROR, ERROR_4, inFilePath.string().c_str());
+        // the parser reads the rest through the same mapping
+        if (c_int status = mySourceFile.open(inFilePath); status != SUCCESS) {
+            return status;
         }
-
-        fseek(f_in, 0, SEEK_END);
-        c_u64 input_size = ftell(f_in);
-        fseek(f_in, 0, SEEK_SET);
-        if (input_size < 12) {
+        if (mySourceFile.size() < 12) {
             return printf_err(FILE_ERROR, ERROR_5);
         }
         HeaderUnion headerUnion{};
-        fread(&headerUnion, 1, 12, f_in);
-        fclose(f_in);
+        std::memcpy(&headerUnion, mySourceFile.data(), 12);
+
+        if (detectConsole(headerUnion, inFilePath, myReadSettings) != SUCCESS) {
+            return printf_err(INVALID_SAVE, ERROR_3);
+        }
+        return SUCCESS;
+    }
+
+
+    int FileListing::detectConsole(const HeaderUnion& headerUnion, const fs::path& inFilePath,
+                                   StateSettings& theSettings) {
+        static constexpr uint32_t CON_MAGIC = 0x434F4E20;
+        static constexpr uint32_t ZLIB_MAGIC = 0x789C;
 
-        Data data;
-        data.setScopeDealloc(true);
         if (headerUnion.getInt1() <= 2) {
             if (headerUnion.getShort5() == ZLIB_MAGIC) {
                 if (headerUnion.getInt2Swap() >= headerUnion.getDestSize()) {
-                    myReadSettings.setConsole(lce::CONSOLE::WIIU);
+                    theSettings.setConsole(lce::CONSOLE::WIIU);
                 } else {
-                    const std::string parentDir = myReadSettings.getFilePath().parent_path().filename().string();
-                    myReadSettings.setConsole(lce::CONSOLE::SWITCH);
+                    const std::string parentDir = inFilePath.parent_path().filename().string();
+                    theSettings.setConsole(lce::CONSOLE::SWITCH);
                     if (parentDir == "savedata0") {
-                        myReadSettings.setConsole(lce::CONSOLE::PS4);
+                        theSettings.setConsole(lce::CONSOLE::PS4);
                     }
                 }
             } else {
@@ -172,26 +201,26 @@ namespace editor {
                 // TODO: with custom vitaRLE decompress checker
                 c_u32 indexFromSF = headerUnion.getInt2Swap() - headerUnion.getInt3Swap();
                 if (indexFromSF > 0 && indexFromSF < 65536) {
-                    myReadSettings.setConsole(lce::CONSOLE::VITA);
+                    theSettings.setConsole(lce::CONSOLE::VITA);
                 } else { // compressed ps3
-                    myReadSettings.setConsole(lce::CONSOLE::PS3);
+                    theSettings.setConsole(lce::CONSOLE::PS3);
                 }
             }
         } else if (headerUnion.getInt2() <= 2) {
             /// if (int2 == 0) it is an xbox savefile unless it's a massive
             /// file, but there won't be 2 files in a savegame file for PS3
-            myReadSettings.setConsole(lce::CONSOLE::XBOX360);
-            myReadSettings.setIsXbox360BIN(false);
+            theSettings.setConsole(lce::CONSOLE::XBOX360);
+            theSettings.setIsXbox360BIN(false);
             // TODO: don't use arbitrary guess for a value
         } else if (headerUnion.getInt2() < 100) { // uncompressed PS3 / RPCS3
             /// otherwise if (int2) > 100 then it is a random file
             /// because likely ps3 won't have more than 100 files
-            myReadSettings.setConsole(lce::CONSOLE::RPCS3);
+            theSettings.setConsole(lce::CONSOLE::RPCS3);
         } else if (headerUnion.getInt1() == CON_MAGIC) {
-            myReadSettings.setConsole(lce::CONSOLE::XBOX360);
-            myReadSettings.setIsXbox360BIN(true);
+            theSettings.setConsole(lce::CONSOLE::XBOX360);
+            theSettings.setIsXbox360BIN(true);
         } else {
-            return printf_err(INVALID_SAVE, ERROR_3);
+            return INVALID_SAVE;
         }
 
         return SUCCESS;
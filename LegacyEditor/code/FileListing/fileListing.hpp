@@ -14,11 +14,15 @@
 #include "stateSettings.hpp"
 #include "writeSettings.hpp"
 
+#include "LegacyEditor/code/Chunk/blockReplace.hpp"
 #include "LegacyEditor/code/ConsoleParser/ConsoleParser.hpp"
+#include "LegacyEditor/code/ConsoleParser/headerUnion.hpp"
 #include "LegacyEditor/code/FileInfo/FileInfo.hpp"
 #include "LegacyEditor/code/LCEFile/LCEFile.hpp"
+#include "LegacyEditor/code/Region/ConversionCache.hpp"
 #include "LegacyEditor/code/Region/RegionManager.hpp"
 #include "LegacyEditor/utils/error_status.hpp"
+#include "LegacyEditor/utils/mappedFile.hpp"
 
 
 class ConsoleParser;
@@ -30,8 +34,7 @@ namespace editor {
     public:
         void removeAll() {
             for (LCEFile* file : *this) {
-                delete[] file->data.data;
-                file->data.data = nullptr;
+                file->deleteData();
             }
             clear();
         }
@@ -50,6 +53,9 @@ namespace editor {
         FileInfo fileInfo{};
         Picture icon0png;
 
+        /// the save file being read, findConsole and the parser share it.
+        MappedFile mySourceFile;
+
         /// Constructors
 
         FileListing();
@@ -62,7 +68,7 @@ namespace editor {
 
         /// Functions
 
-        MU ND int dumpToFolder(const fs::path& inDirPath) const;
+        MU ND int dumpToFolder(const fs::path& inDirPath);
 
         /// Modify State
 
@@ -74,7 +80,17 @@ namespace editor {
         /// Parse from console files
 
         MU ND int read(const fs::path& theFilePath);
+        /// only keeps the files of theFileTypes, the rest are never copied out of the save.
+        /// If any were left out, write() refuses the listing, as it is no longer the whole save.
+        MU ND int read(const fs::path& theFilePath, const std::set<lce::FILETYPE>& theFileTypes);
         MU ND int write(WriteSettings& theWriteSettings);
+        /// reads every file that is still only registered from its external file, in parallel.
+        MU ND int loadExternalFiles();
+
+        /// works out the console from the first 12 bytes of a save, and its path for the ones that share a format.
+        /// It prints nothing, so anything can be probed with it: a non-save is only INVALID_SAVE.
+        MU ND static int detectConsole(const HeaderUnion& headerUnion, const fs::path& inFilePath,
+                                       StateSettings& theSettings);
 
         /// Conversion
 
@@ -84,9 +100,10 @@ namespace editor {
 
         /// Region Helpers
 
-        MU void convertRegions(lce::CONSOLE consoleOut);
+        MU void convertRegions(lce::CONSOLE consoleOut, ConversionCache* theCache = nullptr);
         MU void pruneRegions();
         MU void replaceRegionOW(size_t regionIndex, editor::RegionManager& region, lce::CONSOLE consoleOut);
+        MU ND int replaceBlocks(const chunk::BlockMapping& mapping);
 
         /// File pointer stuff
 
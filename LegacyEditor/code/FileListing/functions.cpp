@@ -1,12 +1,18 @@
 #include "fileListing.hpp"
 
+#include <atomic>
+#include <cassert>
+#include <cstring>
 #include <iostream>
 #include <algorithm>
+#include <functional>
 
 #include "include/ghc/fs_std.hpp"
 
 
+#include "LegacyEditor/code/Chunk/blockView.hpp"
 #include "LegacyEditor/code/Region/RegionManager.hpp"
+#include "LegacyEditor/code/threaded.hpp"
 #include "LegacyEditor/utils/NBT.hpp"
 
 
@@ -40,7 +46,11 @@ namespace editor {
      * @param inDirPath
      * @return
      */
-    int FileListing::dumpToFolder(const fs::path& inDirPath) const {
+    int FileListing::dumpToFolder(const fs::path& inDirPath) {
+        if (c_int status = loadExternalFiles(); status != SUCCESS) {
+            return status;
+        }
+
         const fs::path consoleDirPath = inDirPath / ("dump/" + consoleToStr(myReadSettings.getConsole()));
 
         // deletes all files in "DIR/dump/CONSOLE/".
@@ -91,6 +101,30 @@ namespace editor {
     }
 
 
+    int FileListing::loadExternalFiles() {
+        std::vector<LCEFile*> unloaded;
+        for (LCEFile& file : myAllFiles) {
+            if (!file.isLoaded()) {
+                unloaded.push_back(&file);
+            }
+        }
+        if (unloaded.empty()) {
+            return SUCCESS;
+        }
+
+        // each file only touches its own data
+        std::atomic<int> status = SUCCESS;
+        run_parallel<4>(std::function<void(int)>([&unloaded, &status](c_int theThread) {
+            for (size_t index = theThread; index < unloaded.size(); index += 4) {
+                if (c_int fileStatus = unloaded[index]->load(); fileStatus != SUCCESS) {
+                    status = fileStatus;
+                }
+            }
+        }));
+        return status;
+    }
+
+
     void FileListing::deallocate() {
         for (LCEFile& file : myAllFiles) {
             file.deleteData();
@@ -155,28 +189,19 @@ namespace editor {
     }
 
 
-    MU void FileListing::convertRegions(const lce::CONSOLE consoleOut) {
-        // int index = 0;
-        // int index2 = 0;
+    MU void FileListing::convertRegions(const lce::CONSOLE consoleOut, ConversionCache* theCache) {
         for (const FileList* fileList : ptrs.dimFileLists) {
-            // printf("list %d\n", index);
-            // index++;
-            // index2 = 0;
             for (LCEFile* file : *fileList) {
-                // printf("    file %d\n", index2);
-                // index2++;
-
-
-
-                // don't convert it if it's already the correct console version
-                // if (file->console == consoleOut) {
-                //     continue;
-                // }
+                // with a cache, a region already in consoleOut's format is kept byte for byte.
+                // without one it is read and written again, which re-packs its sectors, as it always was
+                if (theCache != nullptr && file->console == consoleOut) {
+                    continue;
+                }
                 RegionManager region;
                 region.read(file);
-                region.convertChunks(consoleOut);
+                region.convertChunks(consoleOut, theCache);
                 Data data = region.write(consoleOut);
-                file->data.steal(data);
+                file->steal(data);
                 file->console = consoleOut;
             }
         }
@@ -256,9 +281,153 @@ namespace editor {
             throw std::runtime_error(
                 "attempted to call FileListing::replaceRegionOW with an index that is out of bounds.");
         }
-        ptrs.region_overworld[regionIndex]->data.deallocate();
-        ptrs.region_overworld[regionIndex]->data = region.write(consoleOut);
+        Data data = region.write(consoleOut);
+        ptrs.region_overworld[regionIndex]->steal(data);
+    }
+
+
+
+#ifndef NDEBUG
+    static void readDecompressed(ChunkManager& theChunk, c_u8* theData, c_u32 theSize, const lce::CONSOLE theConsole) {
+        theChunk.setScopeDealloc(true);
+        theChunk.allocate(theSize);
+        std::memcpy(theChunk.data, theData, theSize);
+        theChunk.fileData.setCompressedFlag(0);
+        theChunk.readChunk(theConsole);
+    }
+
+
+    /**
+     * What replaceBlocks' in-place patch stands in for: theOriginal decoded with mapping applied
+     * has to hold the same blocks as thePatched decoded, and for V12, which can be written,
+     * both encoded again have to be the same bytes.
+     */
+    static bool isPatchSameAsFullPath(const std::vector<u8>& theOriginal, const ChunkManager& thePatched,
+                                      const chunk::BlockMapping& mapping, const lce::CONSOLE console) {
+        ChunkManager full;
+        ChunkManager patched;
+        readDecompressed(full, theOriginal.data(), theOriginal.size(), console);
+        readDecompressed(patched, thePatched.data, thePatched.size, console);
+
+        chunk::ChunkData* fullData = full.chunkData;
+        chunk::forEachBlock(*fullData, [&mapping](int, int, int, c_u16 block) { return mapping[block]; });
+        if (fullData->hasSubmerged) {
+            for (u16& block : fullData->submerged) {
+                block = mapping[block];
+            }
+        }
+        if (fullData->newBlocks != patched.chunkData->newBlocks
+            || fullData->submerged != patched.chunkData->submerged) {
+            return false;
+        }
+        if (fullData->lastVersion != 12) {
+            return true;
+        }
+        return full.writeChunk(console) == SUCCESS && patched.writeChunk(console) == SUCCESS
+               && full.size == patched.size && std::memcmp(full.data, patched.data, full.size) == 0;
     }
+#endif
+
+
+    /**
+     * Replaces blocks in every region of the save.\n
+     * V12 / V13 chunks are patched in place (inflate, patch palettes, deflate);
+     * V12 chunks that cannot be patched fall back to a full decode / encode.
+     * Other chunk versions are left untouched, and so are regions where nothing was replaced.
+     * @param mapping
+     * @return SUCCESS, NOT_IMPLEMENTED if the save's chunks cannot be recompressed,
+     * or the status of the first chunk that could not be patched; the rest still are.
+     */
+    MU ND int FileListing::replaceBlocks(const chunk::BlockMapping& mapping) {
+        const lce::CONSOLE console = myReadSettings.getConsole();
+        if (console == lce::CONSOLE::XBOX360) {
+            return printf_err(NOT_IMPLEMENTED, "replaceBlocks: cannot recompress XBOX360 chunks\n");
+        }
+        if (mapping.empty()) {
+            return SUCCESS;
+        }
+
+        int failed = 0;
+        int failedStatus = SUCCESS;
+        for (const FileList* fileList : ptrs.dimFileLists) {
+            for (LCEFile* file : *fileList) {
+                RegionManager region;
+                region.read(file);
 
+                bool isRegionChanged = false;
+                MU bool isPatchChecked = false;
+                for (ChunkManager& chunkManager : region.chunks) {
+                    if (chunkManager.size == 0) {
+                        continue;
+                    }
+                    // other versions are not patched, so they are not even inflated when it can be helped
+                    if (c_int version = chunkManager.peekVersion(console);
+                        version != -1 && version != 12 && version != 13) {
+                        continue;
+                    }
+                    chunkManager.ensureDecompress(console);
+                    c_int version = chunkManager.checkVersion();
+                    if (version != 12 && version != 13) {
+                        chunkManager.ensureCompressed(console);
+                        continue;
+                    }
+
+                    bool isChanged = false;
+#ifndef NDEBUG
+                    // debug builds hold the first patched chunk of each region to the full path
+                    std::vector<u8> original;
+                    if (!isPatchChecked) {
+                        original.assign(chunkManager.data, chunkManager.data + chunkManager.size);
+                    }
+#endif
+                    int status = chunk::replaceBlocksInPlace(chunkManager.data, chunkManager.size, mapping, isChanged);
+#ifndef NDEBUG
+                    if (status == SUCCESS && isChanged && !isPatchChecked) {
+                        isPatchChecked = true;
+                        assert(isPatchSameAsFullPath(original, chunkManager, mapping, console));
+                    }
+#endif
+                    if (status == NOT_IMPLEMENTED && version == 12) {
+                        chunkManager.readChunk(console);
+                        auto* chunkData = chunkManager.chunkData;
+                        auto replace = [&mapping, &isChanged](int, int, int, c_u16 block) {
+                            isChanged |= mapping[block] != block;
+                            return mapping[block];
+                        };
+                        chunk::forEachBlock(*chunkData, replace);
+                        if (chunkData->hasSubmerged) {
+                            for (u16& block : chunkData->submerged) {
+                                isChanged |= mapping[block] != block;
+                                block = mapping[block];
+                            }
+                        }
+                        status = SUCCESS;
+                        if (isChanged) {
+                            status = chunkManager.writeChunk(console);
+                        }
+                    }
+                    if (status != SUCCESS) {
+                        failed++;
+                        if (failedStatus == SUCCESS) {
+                            failedStatus = status;
+                        }
+                    }
+                    isRegionChanged |= isChanged;
+                    chunkManager.ensureCompressed(console);
+                }
+
+                if (!isRegionChanged) {
+                    continue;
+                }
+                Data data = region.write(console);
+                file->steal(data);
+            }
+        }
+
+        if (failed != 0) {
+            printf("replaceBlocks: %d chunks could not be patched\n", failed);
+        }
+        return failedStatus;
+    }
 
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <set>
 #include <utility>
 
 #include "include/ghc/fs_std.hpp"
@@ -22,6 +23,14 @@ namespace editor {
 
         bool isXbox360BIN = false;
         bool hasSepRegions = false;
+        /// the types read() keeps, empty for all of them.
+        std::set<lce::FILETYPE> myFileTypes;
+        /// set when read() left out a file that is not one of myFileTypes.
+        bool isPartial = false;
+        /// a preference rather than state, so reset() keeps it.
+        bool lazyExternalFiles = false;
+        /// where inflated listings are cached, empty to not cache them. Also kept by reset().
+        fs::path myListingCacheFolder;
 
     public:
         StateSettings() = default;
@@ -33,6 +42,8 @@ namespace editor {
             myCurrentVersion = 0;
             isXbox360BIN = false;
             hasSepRegions = false;
+            myFileTypes.clear();
+            isPartial = false;
             myConsole = lce::CONSOLE::NONE;
         }
 
@@ -54,6 +65,27 @@ namespace editor {
         MU void setHasSepRegions(bool theBool) { hasSepRegions = theBool; }
         MU ND bool getHasSepRegions() const { return hasSepRegions; }
 
+        MU void setFileTypes(std::set<lce::FILETYPE> theFileTypes) { myFileTypes = std::move(theFileTypes); }
+        MU ND const std::set<lce::FILETYPE>& getFileTypes() const { return myFileTypes; }
+        MU ND bool wantsFileType(const lce::FILETYPE theFileType) const {
+            return myFileTypes.empty() || myFileTypes.contains(theFileType);
+        }
+
+        /// a partial listing is missing files of the save, so it cannot be written back out as one.
+        MU void setIsPartial(bool theBool) { isPartial = theBool; }
+        MU ND bool getIsPartial() const { return isPartial; }
+
+        /// PS4 / Switch region files are only read when first used, instead of while reading the save.
+        MU void setLazyExternalFiles(bool theBool) { lazyExternalFiles = theBool; }
+        MU ND bool getLazyExternalFiles() const { return lazyExternalFiles; }
+
+        /**
+         * Keeps each save's inflated listing in theFolder, so reading the save again
+         * maps it instead of inflating GAMEDATA, for as long as the save is unchanged.
+         */
+        MU void setListingCacheFolder(fs::path theFolder) { myListingCacheFolder = std::move(theFolder); }
+        MU ND const fs::path& getListingCacheFolder() const { return myListingCacheFolder; }
+
 
     };
 
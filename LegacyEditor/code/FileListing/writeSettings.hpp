@@ -25,6 +25,7 @@ namespace editor {
         lce::CONSOLE myConsole;
         fs::path myInFolderPath;
         fs::path myOutFilePath;
+        fs::path myConversionCachePath;
 
 
     public:
@@ -69,6 +70,11 @@ namespace editor {
 
         MU void setOutFilePath(const fs::path& theOutFilePath) { myOutFilePath = theOutFilePath; }
 
+        /// a ConversionCache file that write() converts regions through and updates, empty for none.
+        MU ND fs::path getConversionCachePath() const { return myConversionCachePath; }
+
+        MU void setConversionCachePath(const fs::path& thePath) { myConversionCachePath = thePath; }
+
         MU ND bool areSettingsValid() const {
             if (myConsole == lce::CONSOLE::PS3 && !myProductCodes.isVarSetPS3()) return false;
             if (myConsole == lce::CONSOLE::PS4 && !myProductCodes.isVarSetPS4()) return false;
@@ -1,6 +1,11 @@
 #include "LCEFile.hpp"
 
+#include <cstring>
+
 #include "LegacyEditor/utils/NBT.hpp"
+#include "LegacyEditor/utils/RLE/rle_nsxps4.hpp"
+#include "LegacyEditor/utils/dataManager.hpp"
+#include "LegacyEditor/utils/mappedFile.hpp"
 
 
 namespace editor {
@@ -30,6 +35,12 @@ namespace editor {
     }
 
 
+    LCEFile::LCEFile(const lce::CONSOLE consoleIn, u8* dataIn, c_u32 sizeIn, c_u64 timestampIn, FileSlab slabIn) :
+        LCEFile(consoleIn, dataIn, sizeIn, timestampIn) {
+        slab = std::move(slabIn);
+    }
+
+
     LCEFile::~LCEFile() {
         if (nbt == nullptr) {
             return;
@@ -42,9 +53,55 @@ namespace editor {
 
     // TODO: why doesn't this delete NBT?
     void LCEFile::deleteData() {
-        delete[] data.data;
+        if (slab != nullptr) {
+            // the last file to let go of the slab frees it
+            slab.reset();
+        } else {
+            delete[] data.data;
+        }
         data.data = nullptr;
         data.size = 0;
+        // replaced or dropped, either way it must not be loaded over later
+        source.clear();
+    }
+
+
+    /// copy-on-write, for before data is modified in place. Replacing it with steal() needs no copy.
+    void LCEFile::ensureOwned() {
+        if (slab == nullptr) {
+            return;
+        }
+        Data copy;
+        copy.allocate(data.size);
+        std::memcpy(copy.data, data.data, data.size);
+        steal(copy);
+    }
+
+
+    int LCEFile::load() {
+        if (source.empty()) {
+            return SUCCESS;
+        }
+
+        // map the file, it is only read once so it never gets copied onto the heap
+        MappedFile fileIn;
+        if (fileIn.open(source) != SUCCESS) {
+            return FILE_ERROR;
+        }
+        if (fileIn.size() < 4) {
+            return printf_err(INVALID_SAVE, ERROR_5);
+        }
+        DataManager managerIn(fileIn.data(), fileIn.size(), false); // all of newgen is little endian
+        c_u32 fileSize = managerIn.readInt32();
+
+        Data dataOut;
+        if (!dataOut.allocate(fileSize)) {
+            return printf_err(MALLOC_FAILED, ERROR_1, fileSize);
+        }
+        RLE_NSX_OR_PS4_DECOMPRESS(managerIn.ptr, managerIn.size - 4, dataOut.data, dataOut.size);
+
+        steal(dataOut);
+        return SUCCESS;
     }
 
 
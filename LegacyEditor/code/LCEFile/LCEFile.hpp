@@ -1,5 +1,9 @@
 #pragma once
 
+#include <memory>
+
+#include "include/ghc/fs_std.hpp"
+
 #include "lce/enums.hpp"
 #include "lce/processor.hpp"
 
@@ -12,8 +16,16 @@ class NBTTagCompound;
 namespace editor {
 
 
+    /// The inflated listing, that the files read from it borrow their data from.
+    using FileSlab = std::shared_ptr<u8[]>;
+
+
     class LCEFile {
         NBTTagCompound* nbt = nullptr;
+        /// set while data points into the listing's slab, instead of owning its memory.
+        FileSlab slab;
+        /// set while data has not been read from its external file yet.
+        fs::path source;
     public:
         Data data;
         u64 timestamp = 0;
@@ -25,6 +37,7 @@ namespace editor {
         explicit LCEFile(lce::CONSOLE consoleIn, u32 sizeIn);
         LCEFile(lce::CONSOLE consoleIn, u32 sizeIn, u64 timestampIn);
         LCEFile(lce::CONSOLE consoleIn, u8* dataIn, u32 sizeIn, u64 timestampIn);
+        LCEFile(lce::CONSOLE consoleIn, u8* dataIn, u32 sizeIn, u64 timestampIn, FileSlab slabIn);
 
         ~LCEFile();
 
@@ -40,8 +53,18 @@ namespace editor {
                    fileType == lce::FILETYPE::ENTITY_END;
         }
 
+        /// data must only be freed or replaced through these, it may be borrowed.
         void deleteData();
-        MU void steal(Data& other) { data.steal(other); }
+        MU void steal(Data& other) { deleteData(); data.steal(other); }
+        MU void ensureOwned();
+        MU ND bool isBorrowed() const { return slab != nullptr; }
+
+        /// defers reading data to load(), from a PS4 / Switch "GAMEDATA_" file.
+        MU void setExternalSource(const fs::path& sourceIn) { source = sourceIn; }
+        MU ND bool isLoaded() const { return source.empty(); }
+        MU ND const fs::path& getExternalSource() const { return source; }
+        /// reads and decompresses the external file, if it was not already.
+        MU ND int load();
 
         ND std::string constructFileName(lce::CONSOLE console, bool separateRegions) const;
         MU ND bool isEmpty() const { return data.size != 0; }
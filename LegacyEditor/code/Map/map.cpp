@@ -19,7 +19,9 @@ namespace editor::map {
         }
 
         DataManager mapManager(map->data);
-        c_auto *const data = NBT::readTag(mapManager);
+        // the colors are only read, so they are left in the file's data
+        NBTArena arena;
+        c_auto *const data = NBT::readTag(mapManager, arena, true);
         c_auto* byteArray = NBTBase
                 ::toType<NBTTagCompound>(data)
                 ->getCompoundTag("data")
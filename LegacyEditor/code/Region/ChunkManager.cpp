@@ -7,6 +7,9 @@
 
 #include "lce/processor.hpp"
 
+#include "LegacyEditor/utils/NBT.hpp"
+#include "LegacyEditor/utils/NBTVisitor.hpp"
+#include "LegacyEditor/utils/outputBuffer.hpp"
 #include "LegacyEditor/utils/RLE/rle.hpp"
 #include "LegacyEditor/utils/XBOX_LZX/XDecompress.hpp"
 
@@ -51,6 +54,83 @@ namespace editor {
     }
 
 
+    enum class CHUNK_CODEC : u8 {
+        NONE,
+        XMEM,
+        DEFLATE, // raw deflate stream
+        ZLIB,
+    };
+
+
+    static CHUNK_CODEC getChunkCodec(const lce::CONSOLE console) {
+        switch (console) {
+            case lce::CONSOLE::XBOX360:
+                return CHUNK_CODEC::XMEM;
+            case lce::CONSOLE::PS3:
+            case lce::CONSOLE::RPCS3:
+                return CHUNK_CODEC::DEFLATE;
+            case lce::CONSOLE::SWITCH:
+            case lce::CONSOLE::WIIU:
+            case lce::CONSOLE::VITA:
+            case lce::CONSOLE::PS4:
+                return CHUNK_CODEC::ZLIB;
+            default:
+                return CHUNK_CODEC::NONE;
+        }
+    }
+
+
+    /**
+     * Whether a chunk compressed for one console can be copied as-is to
+     * another: both use the same compression and the same RLE.\n
+     * Only the region / chunk headers differ, and those are rewritten
+     * by RegionManager::write in the output console's endian.
+     */
+    MU bool ChunkManager::sharesCodec(const lce::CONSOLE first, const lce::CONSOLE second) {
+        if (first == second) {
+            return true;
+        }
+        c_auto codec = getChunkCodec(first);
+        return codec != CHUNK_CODEC::NONE && codec == getChunkCodec(second);
+    }
+
+
+    /**
+     * Reads the chunk version without decompressing the whole chunk.\n
+     * Only the first two bytes are inflated; the RLE leaves them as-is
+     * for V8 - V13 chunks, so those versions compare exactly.
+     * @return the version, or -1 if it could not be read.
+     */
+    MU int ChunkManager::peekVersion(const lce::CONSOLE consoleIn) const {
+        if (data == nullptr || size < 2) {
+            return -1;
+        }
+        if (fileData.getCompressedFlag() == 0U) {
+            return checkVersion();
+        }
+
+        // skip the zlib header, the rest is a raw deflate stream
+        u32 headerSize;
+        switch (getChunkCodec(consoleIn)) {
+            case CHUNK_CODEC::ZLIB:
+                headerSize = 2;
+                break;
+            case CHUNK_CODEC::DEFLATE:
+                headerSize = 0;
+                break;
+            default:
+                return -1;
+        }
+
+        // tinf stops with TINF_BUF_ERROR once the two bytes are written,
+        // anything it could not write stays 0xFF and won't match a version
+        u8 header[2] = {0xFF, 0xFF};
+        u32 headerLen = sizeof(header);
+        tinf_uncompress(header, &headerLen, data + headerSize, size - headerSize);
+        return header[0] << 8 | header[1];
+    }
+
+
     MU void ChunkManager::readChunk(MU const lce::CONSOLE inConsole) {
         // cannot read chunk if there is no data
         if (size == 0) {
@@ -83,17 +163,33 @@ namespace editor {
     }
 
 
-    MU void ChunkManager::writeChunk(MU lce::CONSOLE outConsole) {
-        Data outBuffer;
-        outBuffer.allocate(CHUNK_BUFFER_SIZE);
-        memset(outBuffer.data, 0, CHUNK_BUFFER_SIZE);
-        DataManager managerOut(outBuffer);
+    /// what a chunk writer puts before the NBT can be at most, 0 if there is no writer for theVersion.
+    static u32 getBodyBound(c_int theVersion) {
+        switch (theVersion) {
+            case V_8:
+            case V_9:
+            case V_11:
+                return chunk::ChunkV11::getWriteBound();
+            case V_12:
+                return chunk::ChunkV12::getWriteBound();
+            default:
+                return 0;
+        }
+    }
+
 
+    MU int ChunkManager::writeChunk(MU lce::CONSOLE outConsole) {
+        // V10 is all NBT, which has no upper bound, and V13 has no writer
+        c_u32 bodyBound = getBodyBound(chunkData->lastVersion);
+        if (bodyBound == 0) {
+            return printf_err(NOT_IMPLEMENTED,
+                "ChunkManager::writeChunk: cannot write v%d chunks\n", chunkData->lastVersion);
+        }
+
+        OutputBuffer bufferOut;
+        DataManager managerOut = bufferOut.view(bodyBound);
 
         switch (chunkData->lastVersion) {
-            case V_NBT:
-                chunk::ChunkV10(chunkData, &managerOut).writeChunk();
-                break;
             case V_8:
             case V_9:
             case V_11:
@@ -104,22 +200,26 @@ namespace editor {
                 managerOut.writeInt16(chunkData->lastVersion);
                 chunk::ChunkV12(chunkData, &managerOut).writeChunk();
                 break;
-            case V_13:
-                printf("ChunkManager::writeChunk v13 forbidden\n");
-                exit(-1);
             default:;
         }
+        // the writers assert room before each section and light block, so debug builds stop
+        // before a write leaves the view. this is only a sanity check on getWriteBound:
+        // by the time it fails in a release build, the write has already gone past it.
+        if (managerOut.getPosition() > bodyBound) {
+            return printf_err(INVALID_ARGUMENT,
+                "ChunkManager::writeChunk: v%d body overran its %u byte bound\n",
+                chunkData->lastVersion, bodyBound);
+        }
+        bufferOut.commit(managerOut);
 
-        Data outData;
-        outData.allocate(managerOut.getPosition());
-        std::memcpy(outData.data, outBuffer.data, outData.size);
-        outBuffer.deallocate();
+        // untouched NBT is copied back out as it was read
+        chunkData->NBTData.write(bufferOut);
 
-        deallocate();
-        data = outData.data;
-        size = outData.size;
+        Data outData = bufferOut.release();
+        steal(outData);
 
         fileData.setDecSize(size);
+        return SUCCESS;
     }
 
 
@@ -194,8 +294,9 @@ namespace editor {
         fileData.setDecSize(size);
 
         if (fileData.getRLEFlag() == 0U && !skipRLE) {
+            // a lone 0xFF becomes two bytes, so that's the worst case
             Data rleBuffer;
-            rleBuffer.allocate(size);
+            rleBuffer.allocate(size * 2);
             RLE_compress(data, size, rleBuffer.data, rleBuffer.size);
             steal(rleBuffer);
 
@@ -215,8 +316,8 @@ namespace editor {
 
             case lce::CONSOLE::PS3:
             case lce::CONSOLE::RPCS3: {
-                auto *comp_ptr = new u8[size];
-                uLongf comp_size = size;
+                uLongf comp_size = compressBound(size);
+                auto *comp_ptr = new u8[comp_size];
                 status = compress(comp_ptr, &comp_size, data, size);
                 deallocate();
                 if (status != 0) {
@@ -238,8 +339,8 @@ namespace editor {
             case lce::CONSOLE::PS4:
             case lce::CONSOLE::WIIU:
             case lce::CONSOLE::VITA: {
-                auto* comp_ptr = new u8[size];
-                auto comp_size = (uLongf)(float(size) * 1.25F);
+                uLongf comp_size = compressBound(size);
+                auto* comp_ptr = new u8[comp_size];
 
                 status = compress(comp_ptr, &comp_size, data, size);
                 deallocate();
@@ -275,4 +376,136 @@ namespace editor {
     }
 
 
+
+    // #####################################################
+    // #               NBT Tail Section
+    // #####################################################
+
+
+    /// skips COUNT light / data blocks, each is [i32 count][(count + 1) * 128 bytes].
+    template<int COUNT>
+    static bool skipDataBlocks(DataManager& managerIn) {
+        for (int i = 0; i < COUNT; i++) {
+            if (managerIn.getPosition() + 4 > managerIn.size) {
+                return false;
+            }
+            managerIn.incrementPointer((managerIn.readInt32() + 1) * 128);
+        }
+        return true;
+    }
+
+
+    /**
+     * Finds where the chunk's NBT starts, without decoding any blocks.\n
+     * V11 / V12 / V13 chunks store it last, after the heightmap,
+     * terrainPopulated and biomes. The chunk must be decompressed.
+     * @return the offset, or 0 if the chunk has no known layout.
+     */
+    MU u32 ChunkManager::findNBTOffset() const {
+        if (data == nullptr || size < 2 || fileData.getCompressedFlag()) {
+            return 0;
+        }
+
+        DataManager managerIn(data, size);
+        switch (managerIn.readInt16()) {
+            case V_8:
+            case V_9:
+            case V_11: {
+                c_bool hasInhabitedTime = managerIn.readInt16AtOffset(0) != V_8;
+                managerIn.incrementPointer(hasInhabitedTime ? 24 : 16);
+                for (int i = 0; i < 2; i++) {
+                    if (managerIn.getPosition() + 4 > size) { return 0; }
+                    c_i32 blockLength = static_cast<i32>(managerIn.readInt32());
+                    if (blockLength >= 1024) { managerIn.incrementPointer(blockLength); }
+                }
+                if (!skipDataBlocks<6>(managerIn)) { return 0; }
+                break;
+            }
+            case V_12:
+            case V_13: {
+                c_u32 sectionStart = managerIn.readInt16AtOffset(0) == V_12 ? 76 : 78;
+                managerIn.seek(sectionStart - 50);
+                c_u32 maxSectionAddress = managerIn.readInt16() << 8U;
+                managerIn.seek(sectionStart + maxSectionAddress);
+                if (!skipDataBlocks<4>(managerIn)) { return 0; }
+                break;
+            }
+            default:
+                return 0;
+        }
+
+        // heightMap, terrainPopulated, biomes
+        managerIn.incrementPointer(256 + 2 + 256);
+        c_u32 offset = managerIn.getPosition();
+        return offset <= size ? offset : 0;
+    }
+
+
+    /**
+     * Reads only the chunk's NBT (Entities, TileEntities, TileTicks).
+     * @return the NBT, or nullptr if the chunk has none.
+     */
+    MU NBTBase* ChunkManager::readNBTTail() const {
+        c_u32 offset = findNBTOffset();
+        if (offset == 0 || offset >= size || data[offset] != 0x0A) {
+            return nullptr;
+        }
+        DataManager managerIn(data, size);
+        managerIn.seek(offset);
+        return NBT::readTag(managerIn);
+    }
+
+
+    /**
+     * Walks the chunk's NBT with theVisitor, without reading it into a tree.
+     * @return SUCCESS, also if the chunk has none, INVALID_ARGUMENT if the chunk
+     * has no known layout, or INVALID_SAVE if the NBT is malformed.
+     */
+    MU int ChunkManager::visitNBTTail(NBTVisitor& theVisitor) const {
+        c_u32 offset = findNBTOffset();
+        if (offset == 0) {
+            return INVALID_ARGUMENT;
+        }
+        if (offset >= size || data[offset] != 0x0A) {
+            return SUCCESS;
+        }
+        DataManager managerIn(data, size);
+        managerIn.seek(offset);
+        return NBT::visit(managerIn, theVisitor);
+    }
+
+
+    /**
+     * Replaces the chunk's NBT, copying the block, light, heightmap
+     * and biome bytes before it verbatim.
+     * @param nbtIn the new NBT, or nullptr to drop it
+     * @return SUCCESS, or INVALID_ARGUMENT if the chunk has no known layout.
+     */
+    MU int ChunkManager::replaceNBTTail(const NBTBase* nbtIn) {
+        c_u32 offset = findNBTOffset();
+        if (offset == 0) {
+            return INVALID_ARGUMENT;
+        }
+
+        // the body is kept as-is, so the buffer takes it over and appends the new NBT,
+        // growing once to exactly the new size
+        OutputBuffer bufferOut;
+        Data body(data, size);
+        reset();
+        bufferOut.adopt(body);
+        bufferOut.truncate(offset);
+        if (nbtIn != nullptr) {
+            if (!bufferOut.reserve(static_cast<u32>(offset + NBT::serializedSize(nbtIn)))) {
+                NBT::writeTag(nbtIn, bufferOut);
+            } else {
+                NBT::writeTagUnchecked(nbtIn, bufferOut);
+            }
+        }
+
+        Data outData = bufferOut.release();
+        steal(outData);
+        fileData.setDecSize(size);
+        return SUCCESS;
+    }
+
 }
\ No newline at end of file
@@ -8,14 +8,14 @@
 #include "LegacyEditor/code/Chunk/chunkData.hpp"
 
 
+class NBTVisitor;
+
 namespace editor {
     // namespace chunk {
     //     class ChunkData;
     // }
 
     class ChunkManager : public Data {
-        static constexpr u32 CHUNK_BUFFER_SIZE = 0xFFFFFF; // 4,194,303
-
     public:
         struct FileData {
         private:
@@ -77,16 +77,26 @@ namespace editor {
         /// FUNCTIONS
 
         MU ND int checkVersion() const;
+        MU ND int peekVersion(lce::CONSOLE consoleIn) const;
+        MU ND static bool sharesCodec(lce::CONSOLE first, lce::CONSOLE second);
 
         int ensureDecompress(lce::CONSOLE consoleIn, bool skipRLE = false);
         int ensureCompressed(lce::CONSOLE console, bool skipRLE = false);
 
         MU void readChunk(lce::CONSOLE inConsole);
-        MU void writeChunk(lce::CONSOLE outConsole);
+        /// fails without touching the chunk's data if it cannot write chunkData's version.
+        MU int writeChunk(lce::CONSOLE outConsole);
 
         void setSizeFromReading(u32 sizeIn);
         ND u32 getSizeForWriting() const;
 
+        /// NBT TAIL
+
+        MU ND u32 findNBTOffset() const;
+        MU ND NBTBase* readNBTTail() const;
+        MU ND int visitNBTTail(NBTVisitor& theVisitor) const;
+        MU int replaceNBTTail(const NBTBase* nbtIn);
+
     };
 
 }
\ No newline at end of file
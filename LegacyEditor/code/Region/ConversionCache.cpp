@@ -0,0 +1,180 @@
+#include "ConversionCache.hpp"
+
+#include <cstring>
+
+#include "include/zlib-1.2.12/zlib.h"
+
+#include "LegacyEditor/code/Region/ChunkManager.hpp"
+#include "LegacyEditor/utils/dataManager.hpp"
+#include "LegacyEditor/utils/dataReader.hpp"
+#include "LegacyEditor/utils/error_status.hpp"
+#include "LegacyEditor/utils/mappedFile.hpp"
+#include "LegacyEditor/utils/outputBuffer.hpp"
+
+
+namespace editor {
+
+
+    static constexpr u32 CACHE_MAGIC = 0x564E434C; // "LCNV"
+    static constexpr u32 ENTRY_HEADER_SIZE = 8 + 4 + 4 + 1 + 1 + 4 + 4 + 1 + 4;
+
+
+    static u8 getFlags(const ChunkManager::FileData& theFileData) {
+        return static_cast<u8>(theFileData.getCompressedFlag()
+                               | theFileData.getRLEFlag() << 1
+                               | theFileData.getUnknownFlag() << 2);
+    }
+
+
+    /// FNV-1a, a second hash next to the crc32 so two chunks practically never share a key.
+    static u64 hashBytes(u64 theHash, c_u8* theData, c_u32 theSize) {
+        for (u32 index = 0; index < theSize; index++) {
+            theHash = (theHash ^ theData[index]) * 0x100000001B3ULL;
+        }
+        return theHash;
+    }
+
+
+    ConversionCache::Key ConversionCache::makeKey(const ChunkManager& theChunk,
+                                                  const lce::CONSOLE consoleIn, const lce::CONSOLE consoleOut) {
+        // the header decides how the bytes are decoded, so it is part of the key
+        u8 header[11];
+        endian::store<Endian::Little, u32>(header, static_cast<u32>(theChunk.fileData.getDecSize()));
+        endian::store<Endian::Little, u32>(header + 4, theChunk.fileData.getRLESize());
+        endian::store<Endian::Little, u16>(header + 8, CONVERTER_VERSION);
+        header[10] = getFlags(theChunk.fileData);
+
+        Key key;
+        key.hash = hashBytes(0xCBF29CE484222325ULL, header, sizeof(header));
+        key.hash = hashBytes(key.hash, theChunk.data, theChunk.size);
+        key.crc = crc32(crc32(0, nullptr, 0), theChunk.data, theChunk.size);
+        key.size = theChunk.size;
+        key.consoleIn = static_cast<u8>(consoleIn);
+        key.consoleOut = static_cast<u8>(consoleOut);
+        return key;
+    }
+
+
+    bool ConversionCache::apply(const Key& theKey, ChunkManager& theChunk) const {
+        std::lock_guard lock(myMutex);
+        c_auto iter = myEntries.find(theKey);
+        if (iter == myEntries.end()) {
+            return false;
+        }
+        const Entry& entry = iter->second;
+        if (!theChunk.allocate(static_cast<u32>(entry.bytes.size()))) {
+            return false;
+        }
+        std::memcpy(theChunk.data, entry.bytes.data(), entry.bytes.size());
+        theChunk.fileData.setDecSize(entry.decSize);
+        theChunk.fileData.setRLESize(entry.rleSize);
+        theChunk.fileData.setCompressedFlag(entry.flags & 1);
+        theChunk.fileData.setRLEFlag(entry.flags >> 1 & 1);
+        theChunk.fileData.setUnknownFlag(entry.flags >> 2 & 1);
+        return true;
+    }
+
+
+    void ConversionCache::insert(const Key& theKey, const ChunkManager& theChunk) {
+        Entry entry;
+        entry.bytes.assign(theChunk.data, theChunk.data + theChunk.size);
+        entry.decSize = static_cast<u32>(theChunk.fileData.getDecSize());
+        entry.rleSize = theChunk.fileData.getRLESize();
+        entry.flags = getFlags(theChunk.fileData);
+
+        std::lock_guard lock(myMutex);
+        myEntries.insert_or_assign(theKey, std::move(entry));
+        myIsChanged = true;
+    }
+
+
+    size_t ConversionCache::size() const {
+        std::lock_guard lock(myMutex);
+        return myEntries.size();
+    }
+
+
+    bool ConversionCache::isChanged() const {
+        std::lock_guard lock(myMutex);
+        return myIsChanged;
+    }
+
+
+    int ConversionCache::save(const fs::path& thePath) const {
+        std::lock_guard lock(myMutex);
+        OutputBuffer bufferOut;
+        BufferWriter<Endian::Little> writer(bufferOut);
+        writer.writeInt32(CACHE_MAGIC);
+        writer.writeInt16(CONVERTER_VERSION);
+        writer.writeInt32(static_cast<u32>(myEntries.size()));
+
+        for (const auto& [key, entry] : myEntries) {
+            writer.writeInt64(key.hash);
+            writer.writeInt32(key.crc);
+            writer.writeInt32(key.size);
+            writer.writeInt8(key.consoleIn);
+            writer.writeInt8(key.consoleOut);
+            writer.writeInt32(entry.decSize);
+            writer.writeInt32(entry.rleSize);
+            writer.writeInt8(entry.flags);
+            writer.writeInt32(static_cast<u32>(entry.bytes.size()));
+            writer.writeBytes(entry.bytes.data(), static_cast<u32>(entry.bytes.size()));
+        }
+
+        Data dataOut = bufferOut.release();
+        dataOut.setScopeDealloc(true);
+        return DataManager(dataOut).writeToFile(thePath) == 0 ? SUCCESS : FILE_ERROR;
+    }
+
+
+    int ConversionCache::load(const fs::path& thePath) {
+        MappedFile fileIn;
+        if (fileIn.open(thePath) != SUCCESS) {
+            return FILE_ERROR;
+        }
+        DataManager managerIn(fileIn.data(), fileIn.size());
+        DataReader<Endian::Little> reader(managerIn);
+
+        // every read is checked, the cache may be cut short
+        auto fits = [&managerIn](c_u32 theAmount) {
+            return managerIn.getPosition() + static_cast<u64>(theAmount) <= managerIn.size;
+        };
+
+        if (!fits(10) || reader.readInt32() != CACHE_MAGIC || reader.readInt16() != CONVERTER_VERSION) {
+            return printf_err(INVALID_SAVE, "\"%s\" is not a conversion cache of this version\n",
+                              thePath.string().c_str());
+        }
+        c_u32 entryCount = reader.readInt32();
+
+        std::unordered_map<Key, Entry, KeyHasher> entries;
+        for (u32 index = 0; index < entryCount; index++) {
+            if (!fits(ENTRY_HEADER_SIZE)) {
+                return printf_err(INVALID_SAVE, "\"%s\" is cut short\n", thePath.string().c_str());
+            }
+            Key key;
+            key.hash = reader.readInt64();
+            key.crc = reader.readInt32();
+            key.size = reader.readInt32();
+            key.consoleIn = reader.readInt8();
+            key.consoleOut = reader.readInt8();
+            Entry entry;
+            entry.decSize = reader.readInt32();
+            entry.rleSize = reader.readInt32();
+            entry.flags = reader.readInt8();
+            c_u32 byteCount = reader.readInt32();
+            if (!fits(byteCount)) {
+                return printf_err(INVALID_SAVE, "\"%s\" is cut short\n", thePath.string().c_str());
+            }
+            entry.bytes.assign(managerIn.ptr, managerIn.ptr + byteCount);
+            managerIn.incrementPointer(byteCount);
+            entries.insert_or_assign(key, std::move(entry));
+        }
+
+        std::lock_guard lock(myMutex);
+        myEntries = std::move(entries);
+        myIsChanged = false;
+        return SUCCESS;
+    }
+
+
+}
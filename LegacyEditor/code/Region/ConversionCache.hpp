@@ -0,0 +1,78 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "include/ghc/fs_std.hpp"
+
+#include "lce/enums.hpp"
+#include "lce/processor.hpp"
+
+
+namespace editor {
+    class ChunkManager;
+
+
+    /**
+     * Remembers what each compressed chunk became when it was converted, keyed by
+     * a hash of the chunk's bytes and header, the two consoles and CONVERTER_VERSION.\n
+     * RegionManager::convertChunks looks a chunk up before decoding it, so converting
+     * the same world, or a backup of it, again only costs the chunks that changed.\n
+     * Consoles that share a codec never reach it, their chunks are copied as they are.\n
+     * It is kept on disk with save() / load(), and is safe to share between threads.
+     */
+    class ConversionCache {
+    public:
+        /// bump when a conversion changes its output, so old entries are not reused.
+        static constexpr u16 CONVERTER_VERSION = 1;
+
+        struct Key {
+            u64 hash = 0;
+            u32 crc = 0;
+            u32 size = 0;
+            u8 consoleIn = 0;
+            u8 consoleOut = 0;
+
+            bool operator==(const Key& other) const {
+                return hash == other.hash && crc == other.crc && size == other.size
+                       && consoleIn == other.consoleIn && consoleOut == other.consoleOut;
+            }
+        };
+
+    private:
+        struct KeyHasher {
+            size_t operator()(const Key& theKey) const { return theKey.hash; }
+        };
+
+        /// the converted chunk, and the ChunkManager::FileData it was left with.
+        struct Entry {
+            std::vector<u8> bytes;
+            u32 decSize = 0;
+            u32 rleSize = 0;
+            u8 flags = 0;
+        };
+
+        std::unordered_map<Key, Entry, KeyHasher> myEntries;
+        mutable std::mutex myMutex;
+        bool myIsChanged = false;
+
+    public:
+        ND static Key makeKey(const ChunkManager& theChunk, lce::CONSOLE consoleIn, lce::CONSOLE consoleOut);
+
+        /// turns theChunk into its cached conversion.
+        /// @return false if it was never converted, theChunk is left as it was.
+        ND bool apply(const Key& theKey, ChunkManager& theChunk) const;
+        void insert(const Key& theKey, const ChunkManager& theChunk);
+
+        ND size_t size() const;
+        /// whether anything was inserted since it was loaded.
+        ND bool isChanged() const;
+
+        /// @return SUCCESS, FILE_ERROR or INVALID_SAVE if it is not a cache of this CONVERTER_VERSION.
+        ND int load(const fs::path& thePath);
+        ND int save(const fs::path& thePath) const;
+    };
+
+
+}
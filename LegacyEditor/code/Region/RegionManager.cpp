@@ -4,8 +4,11 @@
 #include <cstring>
 
 #include "LegacyEditor/code/LCEFile/LCEFile.hpp"
+#include "LegacyEditor/code/Region/ConversionCache.hpp"
 #include "LegacyEditor/utils/dataManager.hpp"
+#include "LegacyEditor/utils/dataReader.hpp"
 #include "LegacyEditor/utils/error_status.hpp"
+#include "LegacyEditor/utils/outputBuffer.hpp"
 
 
 namespace editor {
@@ -44,7 +47,11 @@ namespace editor {
      * step 7: each chunk gets its own memory
      * @param fileIn
      */
-    int RegionManager::read(const LCEFile* fileIn) {
+    int RegionManager::read(LCEFile* fileIn) {
+        // files from a lazily read save are only loaded now
+        if (c_int status = fileIn->load(); status != SUCCESS) {
+            return status;
+        }
         if (fileIn->data.size == 0) {
             return SUCCESS;
         }
@@ -58,76 +65,100 @@ namespace editor {
         u8 sectors[SECTOR_INTS];
         u32 locations[SECTOR_INTS];
 
-        DataManager managerIn(dataIn, consoleIsBigEndian(myConsole));
-
+        DataManager managerIn(dataIn);
+        return withEndian(consoleIsBigEndian(myConsole), [&](auto endian) -> int {
+            DataReader<decltype(endian)::value> reader(managerIn);
 
-        managerIn.incrementPointer(0x2000);
-        for (chunkIndex = 0; chunkIndex < SECTOR_INTS; chunkIndex++) {
+            managerIn.incrementPointer(0x2000);
+            for (chunkIndex = 0; chunkIndex < SECTOR_INTS; chunkIndex++) {
 
-            // first
-            {
-                c_u32 val = managerIn.readInt32AtOffset(0x0 + chunkIndex * 4);
-                sectors[chunkIndex] = val & 0xFF;
-                locations[chunkIndex] = val >> 8;
-            }
+                // first
+                {
+                    c_u32 val = reader.readInt32AtOffset(0x0 + chunkIndex * 4);
+                    sectors[chunkIndex] = val & 0xFF;
+                    locations[chunkIndex] = val >> 8;
+                }
 
-            // second
-            {
-                c_u32 timestamp = managerIn.readInt32AtOffset(0x1000 + chunkIndex * 4);
-                chunks[chunkIndex].fileData.setTimestamp(timestamp);
-            }
+                // second
+                {
+                    c_u32 timestamp = reader.readInt32AtOffset(0x1000 + chunkIndex * 4);
+                    chunks[chunkIndex].fileData.setTimestamp(timestamp);
+                }
 
-            if (sectors[chunkIndex] == 0) {
-                continue;
-            }
+                if (sectors[chunkIndex] == 0) {
+                    continue;
+                }
 
-            ChunkManager& chunk = chunks[chunkIndex];
+                ChunkManager& chunk = chunks[chunkIndex];
 
-            if (locations[chunkIndex] + sectors[chunkIndex] > totalSectors) {
-                printf("[%u] chunk sector[%u, %u] end goes outside file...\n",
-                       totalSectors, locations[chunkIndex], sectors[chunkIndex]);
-                throw std::runtime_error("RegionManager::read error\n");
-            }
+                if (locations[chunkIndex] + sectors[chunkIndex] > totalSectors) {
+                    printf("[%u] chunk sector[%u, %u] end goes outside file...\n",
+                           totalSectors, locations[chunkIndex], sectors[chunkIndex]);
+                    throw std::runtime_error("RegionManager::read error\n");
+                }
 
-            managerIn.seek(SECTOR_BYTES * locations[chunkIndex]);
-            chunk.setSizeFromReading(managerIn.readInt32());
+                managerIn.seek(SECTOR_BYTES * locations[chunkIndex]);
+                chunk.setSizeFromReading(reader.readInt32());
 
 
-            bool status = chunk.allocate(chunk.size);
-            if (!status) {
-                printf("Failed to allocate %d bytes for chunk", chunk.size);
-                return STATUS::MALLOC_FAILED;
-            }
-            std::memset(chunk.data, 0, chunk.size);
-
-            switch (myConsole) {
-                case lce::CONSOLE::PS3:
-                case lce::CONSOLE::RPCS3: {
-                    chunk.fileData.setDecSize(managerIn.readInt32());
-                    chunk.fileData.setRLESize(managerIn.readInt32());
-                    break;
+                bool status = chunk.allocate(chunk.size);
+                if (!status) {
+                    printf("Failed to allocate %d bytes for chunk", chunk.size);
+                    return STATUS::MALLOC_FAILED;
                 }
-                default:
-                    c_u32 dec_and_rle_size = managerIn.readInt32();
-                    chunk.fileData.setDecSize(dec_and_rle_size);
-                    chunk.fileData.setRLESize(dec_and_rle_size);
-                    break;
-            }
-            std::memcpy(chunk.start(), managerIn.ptr, chunk.size);
+                std::memset(chunk.data, 0, chunk.size);
+
+                switch (myConsole) {
+                    case lce::CONSOLE::PS3:
+                    case lce::CONSOLE::RPCS3: {
+                        chunk.fileData.setDecSize(reader.readInt32());
+                        chunk.fileData.setRLESize(reader.readInt32());
+                        break;
+                    }
+                    default:
+                        c_u32 dec_and_rle_size = reader.readInt32();
+                        chunk.fileData.setDecSize(dec_and_rle_size);
+                        chunk.fileData.setRLESize(dec_and_rle_size);
+                        break;
+                }
+                std::memcpy(chunk.start(), managerIn.ptr, chunk.size);
 
-        }
-        return SUCCESS;
+            }
+            return SUCCESS;
+        });
     }
 
 
-    void RegionManager::convertChunks(lce::CONSOLE consoleIn) {
+    void RegionManager::convertChunks(lce::CONSOLE consoleIn, ConversionCache* theCache) {
+        // the compressed chunks can be copied straight across
+        if (ChunkManager::sharesCodec(myConsole, consoleIn)) {
+            return;
+        }
+
         MU int index = 0;
         for (auto& chunk: chunks) {
             if (chunk.size == 0) continue;
 
+            // looked up before any decoding, that is what the cache saves
+            ConversionCache::Key key;
+            if (theCache != nullptr) {
+                key = ConversionCache::makeKey(chunk, myConsole, consoleIn);
+                if (theCache->apply(key, chunk)) {
+                    index++;
+                    continue;
+                }
+            }
+
             MU c_bool shouldSkipRLE = chunk.fileData.getCompressedFlag();
-            chunk.ensureDecompress(myConsole, shouldSkipRLE);
-            chunk.ensureCompressed(consoleIn, shouldSkipRLE);
+            int status = chunk.ensureDecompress(myConsole, shouldSkipRLE);
+            if (status == SUCCESS) {
+                status = chunk.ensureCompressed(consoleIn, shouldSkipRLE);
+            }
+
+            // a chunk that failed to convert is not worth remembering
+            if (theCache != nullptr && status == SUCCESS) {
+                theCache->insert(key, chunk);
+            }
 
             index++;
         }
@@ -138,10 +169,10 @@ namespace editor {
      * step 1: make sure all chunks are compressed correctly
      * step 2: recalculate sectorCount of each chunk
      * step 3: calculate chunk offsets for each chunk
-     * step 4: allocate memory and create buffer
+     * step 4: create a buffer of the final size
      * step 5: write each chunk offset
      * step 6: write each chunk timestamp
-     * step 7: seek to each location, write chunk attr's, then chunk data
+     * step 7: pad to each location, write chunk attr's, then chunk data
      * @param consoleIn
      * @return
      */
@@ -164,56 +195,47 @@ namespace editor {
             }
         }
 
-        c_u32 data_size = total_sectors * SECTOR_BYTES;
-        Data dataOut;
-        dataOut.allocate(data_size);
-        DataManager managerOut(dataOut, consoleIsBigEndian(consoleIn));
-        std::memset(dataOut.data, 0, dataOut.size);
-
-        u32 largestOffset = 0;
-        managerOut.incrementPointer(0x2000);
-        for (u32 x = 0; x < 32; x++) {
-            for (u32 z = 0; z < 32; z++) {
-                u32 chunkIndex = z * 32 + x;
-
-                u32 chunk_header = sectors[chunkIndex] | locations[chunkIndex] << 8;
-                managerOut.writeInt32AtOffset(0x0 + chunkIndex * 4, chunk_header);
-
-                u32 chunk_timestamp = chunks[chunkIndex].fileData.getTimestamp();
-                managerOut.writeInt32AtOffset(0x1000 + chunkIndex * 4, chunk_timestamp);
+        OutputBuffer bufferOut(total_sectors * SECTOR_BYTES);
+        withEndian(consoleIsBigEndian(consoleIn), [&](auto endian) {
+            constexpr Endian E = decltype(endian)::value;
 
+            for (u32 chunkIndex = 0; chunkIndex < SECTOR_INTS; chunkIndex++) {
+                c_u32 chunk_header = sectors[chunkIndex] | locations[chunkIndex] << 8;
+                bufferOut.writeUnchecked<E, u32>(chunk_header);
+            }
+            for (u32 chunkIndex = 0; chunkIndex < SECTOR_INTS; chunkIndex++) {
+                c_u32 chunk_timestamp = chunks[chunkIndex].fileData.getTimestamp();
+                bufferOut.writeUnchecked<E, u32>(chunk_timestamp);
+            }
 
-                if (sectors[chunkIndex] == 0) {
-                    managerOut.seek(locations[chunkIndex] * SECTOR_BYTES);
-                    managerOut.incrementPointer(8);
-                    if (consoleIn == lce::CONSOLE::PS3 || consoleIn == lce::CONSOLE::RPCS3) {
-                        managerOut.incrementPointer(4);
+            // chunks were given their sectors in this order, so they are written front to back
+            for (u32 x = 0; x < 32; x++) {
+                for (u32 z = 0; z < 32; z++) {
+                    u32 chunkIndex = z * 32 + x;
+                    if (sectors[chunkIndex] == 0) {
+                        continue;
                     }
 
-                } else {
                     ChunkManager& chunk = chunks[chunkIndex];
-                    managerOut.seek(locations[chunkIndex] * SECTOR_BYTES);
-                    managerOut.writeInt32(chunk.getSizeForWriting());
+                    bufferOut.fill(0, locations[chunkIndex] * SECTOR_BYTES - bufferOut.getPosition());
+                    bufferOut.write<E, u32>(chunk.getSizeForWriting());
                     switch (consoleIn) {
                         case lce::CONSOLE::PS3:
                         case lce::CONSOLE::RPCS3:
-                            managerOut.writeInt32(chunk.fileData.getDecSize());
-                            managerOut.writeInt32(chunk.fileData.getRLESize());
+                            bufferOut.write<E, u32>(chunk.fileData.getDecSize());
+                            bufferOut.write<E, u32>(chunk.fileData.getRLESize());
                             break;
                         default:
-                            managerOut.writeInt32(chunk.fileData.getDecSize());
+                            bufferOut.write<E, u32>(chunk.fileData.getDecSize());
                             break;
                     }
-                    managerOut.writeBytes(chunk.start(), chunk.size);
-                    if (managerOut.getPosition() > largestOffset) {
-                        largestOffset = managerOut.getPosition();
-                    }
+                    bufferOut.writeBytes(chunk.start(), chunk.size);
                 }
-
             }
-        }
+        });
 
-        dataOut.size = largestOffset;
-        return dataOut;
+        // ends at the last chunk, its sector is not padded out.
+        // a region without chunks is still its location and timestamp header
+        return bufferOut.release();
     }
 }
\ No newline at end of file
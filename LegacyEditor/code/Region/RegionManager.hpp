@@ -6,6 +6,7 @@
 
 
 namespace editor {
+    class ConversionCache;
     class LCEFile;
 
     class RegionManager {
@@ -31,8 +32,12 @@ namespace editor {
 
         /// READ AND WRITE
 
-        int read(const LCEFile* fileIn);
-        MU void convertChunks(lce::CONSOLE consoleIn);
+        int read(LCEFile* fileIn);
+        /// chunks theCache has already converted are taken from it, the rest are added to it.\n
+        /// consoles that share a codec (see ChunkManager::sharesCodec) copy their chunks across
+        /// before theCache is looked at, so it only ever serves pairs with different codecs:
+        /// Xbox 360, PS3 / RPCS3 and the zlib consoles, to each other.
+        MU void convertChunks(lce::CONSOLE consoleIn, ConversionCache* theCache = nullptr);
         Data write(lce::CONSOLE consoleIn);
 
     };
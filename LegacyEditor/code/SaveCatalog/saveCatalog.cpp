@@ -0,0 +1,341 @@
+#include "saveCatalog.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+#include "include/sfo/sfo.hpp"
+
+#include "LegacyEditor/code/ConsoleParser/ConsoleParser.hpp"
+#include "LegacyEditor/code/FileInfo/FileInfo.hpp"
+#include "LegacyEditor/code/FileListing/fileListing.hpp"
+#include "LegacyEditor/code/threaded.hpp"
+#include "LegacyEditor/utils/dataReader.hpp"
+#include "LegacyEditor/utils/error_status.hpp"
+#include "LegacyEditor/utils/mappedFile.hpp"
+#include "LegacyEditor/utils/outputBuffer.hpp"
+#include "LegacyEditor/utils/utils.hpp"
+
+
+namespace editor {
+
+
+    static constexpr u32 CATALOG_MAGIC = 0x5441434C; // "LCAT"
+    static constexpr u16 CATALOG_VERSION = 2;
+
+
+    static std::string toLower(std::string str) {
+        for (char& chara : str) {
+            chara = static_cast<char>(std::tolower(static_cast<unsigned char>(chara)));
+        }
+        return str;
+    }
+
+
+    /// the names saves go by, the probe sorts out the rest.
+    static bool isSaveCandidate(const fs::path& thePath) {
+        const std::string name = toLower(thePath.filename().string());
+        if (name == "gamedata" || name == "gamedata.bin") {
+            return true;
+        }
+        // "GAMEDATA_" files are PS4 / Switch regions, not saves
+        if (name.starts_with("gamedata_") || name == "thumbdata.bin" || name == "cache.bin") {
+            return false;
+        }
+        if (name.ends_with(".bin") || name == "savegame.dat") {
+            return true;
+        }
+        // WiiU / Switch saves are named by date, with a ".ext" FileInfo next to them
+        fs::path extPath = thePath;
+        extPath += ".ext";
+        std::error_code error;
+        return fs::exists(extPath, error);
+    }
+
+
+    /// playstation saves keep their name in a param.sfo next to them, empty for the rest.
+    static fs::path getSFOPath(const lce::CONSOLE theConsole, const fs::path& theFilePath) {
+        if (theConsole == lce::CONSOLE::PS3 || theConsole == lce::CONSOLE::RPCS3) {
+            return theFilePath.parent_path() / "PARAM.SFO";
+        }
+        if (theConsole == lce::CONSOLE::PS4) {
+            return theFilePath.parent_path() / "sce_sys" / "param.sfo";
+        }
+        return {};
+    }
+
+
+    static i64 getModifiedTime(const fs::path& thePath) {
+        std::error_code error;
+        if (thePath.empty()) {
+            return 0;
+        }
+        c_i64 modifiedTime = fs::last_write_time(thePath, error).time_since_epoch().count();
+        return error ? 0 : modifiedTime;
+    }
+
+
+    /// the newest of the FileInfo and param.sfo the name and thumbnail come from, 0 if there are none.
+    static i64 getMetadataTime(const lce::CONSOLE theConsole, const fs::path& theFilePath) {
+        return std::max(getModifiedTime(ConsoleParser::getFileInfoPath(theConsole, theFilePath)),
+                        getModifiedTime(getSFOPath(theConsole, theFilePath)));
+    }
+
+
+    int SaveCatalog::probe(const fs::path& theFilePath, SaveEntry& theEntry) {
+        std::error_code error;
+        theEntry.filePath = theFilePath;
+        theEntry.fileSize = fs::file_size(theFilePath, error);
+        if (error || theEntry.fileSize < 12) {
+            return INVALID_SAVE;
+        }
+        theEntry.modifiedTime = fs::last_write_time(theFilePath, error).time_since_epoch().count();
+
+        // the same 12 bytes findConsole looks at
+        HeaderUnion headerUnion{};
+        FILE* fileIn = fopen(theFilePath.string().c_str(), "rb");
+        if (fileIn == nullptr) {
+            return FILE_ERROR;
+        }
+        c_u64 amountRead = fread(&headerUnion, 1, 12, fileIn);
+        fclose(fileIn);
+        if (amountRead != 12) {
+            return FILE_ERROR;
+        }
+
+        StateSettings settings;
+        if (FileListing::detectConsole(headerUnion, theFilePath, settings) != SUCCESS) {
+            return INVALID_SAVE;
+        }
+        theEntry.console = settings.getConsole();
+        theEntry.isXbox360BIN = settings.getIsXbox360BIN();
+        theEntry.metadataTime = getMetadataTime(theEntry.console, theFilePath);
+
+        theEntry.fileInfoPath = ConsoleParser::getFileInfoPath(theEntry.console, theFilePath);
+        if (!theEntry.fileInfoPath.empty() && fs::exists(theEntry.fileInfoPath, error)) {
+            FileInfo fileInfo{};
+            if (fileInfo.readFile(theEntry.fileInfoPath, theEntry.console) == SUCCESS) {
+                theEntry.saveName = fileInfo.baseSaveName;
+                theEntry.seed = fileInfo.seed;
+                theEntry.hostOptions = fileInfo.hostOptions;
+                theEntry.texturePack = fileInfo.texturePack;
+                theEntry.loads = fileInfo.loads;
+                theEntry.exploredChunks = fileInfo.exploredChunks;
+                theEntry.thumbnailSize = fileInfo.thumbnail.size;
+            }
+            fileInfo.thumbnail.deallocate();
+        } else {
+            theEntry.fileInfoPath.clear();
+        }
+
+        // playstation saves keep the name in their param.sfo instead
+        if (theEntry.saveName.empty()) {
+            const fs::path sfoPath = getSFOPath(theEntry.console, theFilePath);
+            const char* key = theEntry.console == lce::CONSOLE::PS4 ? "SUBTITLE" : "SUB_TITLE";
+            if (!sfoPath.empty() && fs::exists(sfoPath, error)) {
+                SFOManager sfo(sfoPath.string());
+                theEntry.saveName = stringToWstring(sfo.getAttribute(key));
+            }
+        }
+
+        return SUCCESS;
+    }
+
+
+    int SaveCatalog::readThumbnail(const SaveEntry& theEntry, Data& thumbnailOut) {
+        if (theEntry.fileInfoPath.empty()) {
+            return FILE_ERROR;
+        }
+        FileInfo fileInfo{};
+        if (c_int status = fileInfo.readFile(theEntry.fileInfoPath, theEntry.console); status != SUCCESS) {
+            fileInfo.thumbnail.deallocate();
+            return status;
+        }
+        thumbnailOut.steal(fileInfo.thumbnail);
+        return SUCCESS;
+    }
+
+
+    /// the folders still to be walked, shared by the scan threads.
+    struct ScanQueue {
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::vector<fs::path> folders;
+        /// threads walking a folder, which may still add more.
+        int busyCount = 0;
+    };
+
+
+    int SaveCatalog::scan(const fs::path& rootPath) {
+        std::error_code error;
+        if (!fs::is_directory(rootPath, error)) {
+            return printf_err(FILE_ERROR, ERROR_4, rootPath.string().c_str());
+        }
+
+        // what is already indexed, so unchanged saves are not probed again
+        std::unordered_map<std::string, const SaveEntry*> known;
+        for (const SaveEntry& entry : myEntries) {
+            known.emplace(entry.filePath.string(), &entry);
+        }
+
+        // each thread takes a folder, queues its subfolders and probes its saves,
+        // so slow disks are listed and read from all threads at once
+        ScanQueue queue;
+        queue.folders.push_back(rootPath);
+        std::vector<std::vector<SaveEntry>> foundPerThread(SCAN_THREADS);
+        run_parallel<SCAN_THREADS>(std::function<void(int)>([&queue, &known, &foundPerThread](c_int theThread) {
+            std::vector<SaveEntry>& found = foundPerThread[theThread];
+            std::unique_lock lock(queue.mutex);
+            while (true) {
+                queue.wake.wait(lock, [&queue] { return !queue.folders.empty() || queue.busyCount == 0; });
+                if (queue.folders.empty()) {
+                    return;
+                }
+                const fs::path folder = std::move(queue.folders.back());
+                queue.folders.pop_back();
+                queue.busyCount++;
+                lock.unlock();
+
+                std::vector<fs::path> subFolders;
+                std::error_code iterError;
+                std::error_code fileError;
+                fs::directory_iterator iter(folder, fs::directory_options::skip_permission_denied, iterError);
+                for (; !iterError && iter != fs::directory_iterator(); iter.increment(iterError)) {
+                    const fs::directory_entry& file = *iter;
+                    // like recursive_directory_iterator, linked folders are not followed
+                    if (file.is_directory(fileError) && !file.is_symlink(fileError)) {
+                        subFolders.push_back(file.path());
+                        continue;
+                    }
+                    if (!file.is_regular_file(fileError) || !isSaveCandidate(file.path())) {
+                        continue;
+                    }
+
+                    c_u64 fileSize = file.file_size(fileError);
+                    c_i64 modifiedTime = file.last_write_time(fileError).time_since_epoch().count();
+                    if (c_auto it = known.find(file.path().string()); it != known.end()
+                        && it->second->fileSize == fileSize && it->second->modifiedTime == modifiedTime
+                        && it->second->metadataTime == getMetadataTime(it->second->console, file.path())) {
+                        found.push_back(*it->second);
+                        continue;
+                    }
+                    // anything else is expected to not be a save, so it is dropped quietly
+                    SaveEntry entry;
+                    if (probe(file.path(), entry) == SUCCESS) {
+                        found.push_back(std::move(entry));
+                    }
+                }
+
+                lock.lock();
+                for (fs::path& subFolder : subFolders) {
+                    queue.folders.push_back(std::move(subFolder));
+                }
+                queue.busyCount--;
+                queue.wake.notify_all();
+            }
+        }));
+
+        // the threads finish in any order, the catalog always comes out the same
+        myEntries.clear();
+        for (std::vector<SaveEntry>& found : foundPerThread) {
+            std::move(found.begin(), found.end(), std::back_inserter(myEntries));
+        }
+        std::sort(myEntries.begin(), myEntries.end(), [](const SaveEntry& first, const SaveEntry& second) {
+            return first.filePath < second.filePath;
+        });
+        return SUCCESS;
+    }
+
+
+    int SaveCatalog::save(const fs::path& indexPath) const {
+        OutputBuffer bufferOut;
+        BufferWriter<Endian::Little> writer(bufferOut);
+        writer.writeInt32(CATALOG_MAGIC);
+        writer.writeInt16(CATALOG_VERSION);
+        writer.writeInt32(static_cast<u32>(myEntries.size()));
+
+        for (const SaveEntry& entry : myEntries) {
+            writer.writeUTF(entry.filePath.string());
+            writer.writeUTF(entry.fileInfoPath.string());
+            writer.writeInt8(static_cast<u8>(entry.console));
+            writer.writeInt8(entry.isXbox360BIN);
+            writer.writeInt64(entry.fileSize);
+            writer.writeInt64(entry.modifiedTime);
+            writer.writeInt64(entry.metadataTime);
+            writer.writeUTF(wStringToString(entry.saveName));
+            writer.writeInt64(entry.seed);
+            writer.writeInt64(entry.hostOptions);
+            writer.writeInt64(entry.texturePack);
+            writer.writeInt64(entry.loads);
+            writer.writeInt64(entry.exploredChunks);
+            writer.writeInt32(entry.thumbnailSize);
+        }
+
+        Data dataOut = bufferOut.release();
+        dataOut.setScopeDealloc(true);
+        return DataManager(dataOut).writeToFile(indexPath) == 0 ? SUCCESS : FILE_ERROR;
+    }
+
+
+    int SaveCatalog::load(const fs::path& indexPath) {
+        MappedFile fileIn;
+        if (fileIn.open(indexPath) != SUCCESS) {
+            return FILE_ERROR;
+        }
+        DataManager managerIn(fileIn.data(), fileIn.size());
+        DataReader<Endian::Little> reader(managerIn);
+
+        // every read is checked, the index may be cut short or stale
+        auto fits = [&managerIn](c_u32 theAmount) {
+            return managerIn.getPosition() + theAmount <= managerIn.size;
+        };
+        auto readString = [&reader, &fits](std::string& str) {
+            if (!fits(2)) { return false; }
+            c_u16 length = reader.readInt16AtOffset(reader.manager().getPosition());
+            if (!fits(2 + length)) { return false; }
+            str = reader.readUTF();
+            return true;
+        };
+
+        if (!fits(10) || reader.readInt32() != CATALOG_MAGIC || reader.readInt16() != CATALOG_VERSION) {
+            return printf_err(INVALID_SAVE, "\"%s\" is not a save catalog\n", indexPath.string().c_str());
+        }
+        c_u32 entryCount = reader.readInt32();
+
+        std::vector<SaveEntry> entries;
+        for (u32 index = 0; index < entryCount; index++) {
+            SaveEntry& entry = entries.emplace_back();
+            std::string str;
+            bool isValid = readString(str);
+            entry.filePath = str;
+            isValid = isValid && readString(str);
+            entry.fileInfoPath = str;
+            if (!isValid || !fits(26)) {
+                return printf_err(INVALID_SAVE, "\"%s\" is cut short\n", indexPath.string().c_str());
+            }
+            entry.console = static_cast<lce::CONSOLE>(reader.readInt8());
+            entry.isXbox360BIN = reader.readBool();
+            entry.fileSize = reader.readInt64();
+            entry.modifiedTime = static_cast<i64>(reader.readInt64());
+            entry.metadataTime = static_cast<i64>(reader.readInt64());
+            if (!readString(str) || !fits(44)) {
+                return printf_err(INVALID_SAVE, "\"%s\" is cut short\n", indexPath.string().c_str());
+            }
+            entry.saveName = stringToWstring(str);
+            entry.seed = static_cast<i64>(reader.readInt64());
+            entry.hostOptions = static_cast<i64>(reader.readInt64());
+            entry.texturePack = static_cast<i64>(reader.readInt64());
+            entry.loads = static_cast<i64>(reader.readInt64());
+            entry.exploredChunks = static_cast<i64>(reader.readInt64());
+            entry.thumbnailSize = reader.readInt32();
+        }
+
+        myEntries = std::move(entries);
+        return SUCCESS;
+    }
+
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "include/ghc/fs_std.hpp"
+
+#include "lce/enums.hpp"
+#include "lce/processor.hpp"
+
+#include "LegacyEditor/utils/data.hpp"
+
+
+namespace editor {
+
+
+    /// What the catalog knows about a save, without having read its GAMEDATA.
+    struct SaveEntry {
+        fs::path filePath;
+        /// THUMB / THUMBDATA.BIN / .ext, empty if the save has none.
+        fs::path fileInfoPath;
+        lce::CONSOLE console = lce::CONSOLE::NONE;
+        bool isXbox360BIN = false;
+        u64 fileSize = 0;
+        i64 modifiedTime = 0;
+        /// of the FileInfo or param.sfo, whichever changed last, 0 if it has neither.
+        i64 metadataTime = 0;
+
+        std::wstring saveName;
+        i64 seed = 0;
+        i64 hostOptions = 0;
+        i64 texturePack = 0;
+        i64 loads = 0;
+        i64 exploredChunks = 0;
+        u32 thumbnailSize = 0;
+    };
+
+
+    /**
+     * An index of the saves under a folder, built from the 12 byte header
+     * findConsole probes, the save's FileInfo and its size alone; GAMEDATA is
+     * never inflated.\n
+     * It is kept on disk with save() / load(), and scan() only probes saves
+     * whose size or modification time, or that of their FileInfo or param.sfo,
+     * changed since then.
+     */
+    class SaveCatalog {
+        std::vector<SaveEntry> myEntries;
+
+    public:
+        static constexpr int SCAN_THREADS = 16;
+
+        MU ND const std::vector<SaveEntry>& getEntries() const { return myEntries; }
+
+        /// @return SUCCESS, FILE_ERROR or INVALID_SAVE if it is not a catalog.
+        MU ND int load(const fs::path& indexPath);
+        MU ND int save(const fs::path& indexPath) const;
+
+        /// walks rootPath for saves on SCAN_THREADS threads, reusing the entries of those that did not change.
+        MU ND int scan(const fs::path& rootPath);
+
+        MU ND static int probe(const fs::path& theFilePath, SaveEntry& theEntry);
+        /// reads the PNG thumbnail back out of the entry's FileInfo.
+        MU ND static int readThumbnail(const SaveEntry& theEntry, Data& thumbnailOut);
+    };
+
+
+}
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cassert>
 #include <cstring>
 
 #include "lce/blocks/block_ids.hpp"
 
+#include "LegacyEditor/code/Chunk/blockView.hpp"
+#include "LegacyEditor/code/Chunk/v12.hpp"
 #include "LegacyEditor/code/FileListing/fileListing.hpp"
 #include "LegacyEditor/code/Region/RegionManager.hpp"
 
@@ -17,6 +20,7 @@ namespace editor {
         // read a region file
         RegionManager region;
         region.read(fileListing.ptrs.region_overworld[regionIndex]);
+        int failed = 0;
         for (ChunkManager& chunkManager: region.chunks) {
             if (chunkManager.size == 0) {
                 continue;
@@ -30,76 +34,19 @@ namespace editor {
                 continue;
             }
 
-            u16 blocks[65536];
-            for (u16 x = 0; x < 16; x++) {
-                for (u16 z = 0; z < 16; z++) {
-                    for (u16 y = 0; y < 256; y++) {
-                        u16 block1 = chunkManager.chunkData->getBlock(x, y, z);
-                        u16 data_1 = 0;
-                        c_int offset1 = y + 256 * z + 4096 * x;
-
-                        c_u16 compare1 = (block1 & 0x1FF0) >> 4;
-                        if ((block1 & 0x8000) != 0) { // fix stupid blocks
-                            if (compare1 == 271) {    // sea pickle
-                                block1 = (block1 & 0x9FF7) | 0x08;
-                            }
-                            if (compare1 == 272) { // bubble column
-                                block1 = (block1 & 0x7FFF) | 0b1111;
-                            }
-                        }
-
-                        blocks[offset1] = block1 | data_1;
-
-
-                        /*
-                    block1 = BlockID::AIR_ID;
-                    if (y == 0) { block1 = BlockID::BEDROCK_ID; }
-
-                    u32 jumpBL, jumpDA;
-
-                    if (y == 1) {
-                        if (x % 2 != 0 || z % 2 != 0) {
-                            if (chunkData->chunkX < -16 || chunkData->chunkX > 16 ||
-                                chunkData->chunkZ <   0 || chunkData->chunkZ >  1) {
-                                block1 = BlockID::AIR_ID;
-                                goto END;
-                            }
-                            block1 = BlockID::BEDROCK_ID;
-                            goto END;
-                        }
+            chunk::forEachBlock(*chunkData, [](int, int, int, u16 block1) -> u16 {
+                c_u16 compare1 = (block1 & 0x1FF0) >> 4;
+                if ((block1 & 0x8000) != 0) { // fix stupid blocks
+                    if (compare1 == 271) {    // sea pickle
+                        block1 = (block1 & 0x9FF7) | 0x08;
                     }
-
-                    if (y == 2) {
-                        if (chunkData->chunkX < -16 || chunkData->chunkX > 16 ||
-                            chunkData->chunkZ <   0 || chunkData->chunkZ >  1) {
-                            goto END;
-                        }
-
-                        if (x % 2 != 0 || z % 2 != 0) {
-                            goto END;
-                        }
-
-                        jumpBL = 8 * (chunkData->chunkX + 16);
-                        jumpDA = 8 *  chunkData->chunkZ;
-
-                        block1 = (jumpBL + x / 2) << 4;
-                        data_1 = jumpDA + z / 2;
-
-                        if (block1 > 252 << 4 || block1 == BlockID::BEACON_ID) {
-                            block1 = 0;
-                            data_1 = 0;
-                        }
-                    }
-
-                    END:
-
-                    blocks[offset1] = block1 | data_1;
-                     */
+                    if (compare1 == 272) { // bubble column
+                        block1 = (block1 & 0x7FFF) | 0b1111;
                     }
                 }
-            }
+                return block1;
+            });
 
-            std::memcpy(&chunkData->newBlocks[0], &blocks[0], 131072);
             // shuffleArray(&chunkData->newBlocks[0], 65535);
             // memset(&chunkData->biomes[0], 0x0B, 256);
             // memset(&chunkData->blockLight[0], 0xFF, 32768);
@@ -110,12 +57,19 @@ namespace editor {
             chunkData->inhabitedTime = 200;
 
             chunkData->defaultNBT();
-            chunkManager.writeChunk(console);
+            // a chunk that cannot be written keeps the data it was read with
+            if (chunkManager.writeChunk(console) != SUCCESS) {
+                failed++;
+            }
             chunkManager.ensureCompressed(console);
         }
 
-        fileListing.ptrs.region_overworld[regionIndex]->data.deallocate();
-        fileListing.ptrs.region_overworld[regionIndex]->data = region.write(console);
+        if (failed != 0) {
+            printf("processRegion: %d chunks could not be written\n", failed);
+        }
+
+        Data data = region.write(console);
+        fileListing.ptrs.region_overworld[regionIndex]->steal(data);
     }
 
 
@@ -132,6 +86,7 @@ namespace editor {
         // read a region file
         RegionManager region;
         region.read(fileListing.ptrs.region_nether[regionIndex]);
+        int failed = 0;
 
         for (ChunkManager& chunkManager: region.chunks) {
             if (chunkManager.size == 0) {
@@ -146,35 +101,52 @@ namespace editor {
                 continue;
             }
 
-            u16 blocks[65536];
-            for (u16 x = 0; x < 16; x++) {
-                for (u16 z = 0; z < 16; z++) {
-                    for (u16 y = 0; y < 256; y++) {
-                        u16 block1 = chunkManager.chunkData->getBlock(x, y, z);
-                        c_int offset1 = y + 256 * z + 4096 * x;
-
-                        if ((block1 & 0x1FF0) >> 4 != 7) {
-                            block1 = 0;
-                        }
-
-                        blocks[offset1] = block1;
-                    }
-                }
-            }
+            chunk::forEachBlock(*chunkData, [](int, int, int, c_u16 block1) -> u16 {
+                return (block1 & 0x1FF0) >> 4 != 7 ? 0 : block1;
+            });
 
-            std::memcpy(chunkData->newBlocks.data(), &blocks[0], 131072);
             memset(chunkData->blockLight.data(), 0xFF, 32768);
             memset(chunkData->skyLight.data(), 0xFF, 32768);
             chunkData->terrainPopulated = 2046;
 
             chunkData->defaultNBT();
-            chunkManager.writeChunk(console);
+            // a chunk that cannot be written keeps the data it was read with
+            if (chunkManager.writeChunk(console) != SUCCESS) {
+                failed++;
+            }
             chunkManager.ensureCompressed(console);
         }
 
-        fileListing.ptrs.region_nether[regionIndex]->data.deallocate();
-        fileListing.ptrs.region_nether[regionIndex]->data = region.write(console);
+        if (failed != 0) {
+            printf("removeNetherrack: %d chunks could not be written\n", failed);
+        }
+
+        Data data = region.write(console);
+        fileListing.ptrs.region_nether[regionIndex]->steal(data);
+    }
+
+
+#ifndef NDEBUG
+    /**
+     * What convertChunksToAquatic's fast path stands in for: theChunk, a decompressed V12 chunk,
+     * decoded, given a cleared height map and encoded again, has to be the same bytes as
+     * theChunk with the height map at theHeightMap cleared in place.
+     */
+    static bool isSameAsFullPath(const ChunkManager& theChunk, c_u32 theHeightMap, const lce::CONSOLE theConsole) {
+        std::vector<u8> fast(theChunk.data, theChunk.data + theChunk.size);
+        memset(fast.data() + theHeightMap, 0, 256);
+
+        ChunkManager full;
+        full.setScopeDealloc(true);
+        full.allocate(theChunk.size);
+        std::memcpy(full.data, theChunk.data, theChunk.size);
+        full.fileData.setCompressedFlag(0);
+        full.readChunk(theConsole);
+        memset(full.chunkData->heightMap.data(), 0, 256);
+        return full.writeChunk(theConsole) == SUCCESS
+               && full.size == fast.size() && std::memcmp(full.data, fast.data(), full.size) == 0;
     }
+#endif
 
 
     /**
@@ -191,8 +163,32 @@ namespace editor {
         // read a region file
         RegionManager region;
         region.read(fileList[regionIndex]);
+        int failed = 0;
+        MU bool isFastPathChecked = false;
 
         for (auto & chunkManager : region.chunks) {
+            if (chunkManager.size == 0) continue;
+
+            // chunk payloads are big endian on every console, only the region
+            // and chunk headers follow it, and RegionManager::write handles those.
+            // so aquatic chunks only get the height map cleared below, in place.
+            chunkManager.ensureDecompress(inConsole);
+            if (chunkManager.checkVersion() == 12) {
+                if (c_u32 heightMap = chunk::ChunkV12::findHeightMap(chunkManager.data, chunkManager.size);
+                    heightMap != 0) {
+#ifndef NDEBUG
+                    // debug builds hold the first chunk of each region that takes it to the full path
+                    if (!isFastPathChecked) {
+                        isFastPathChecked = true;
+                        assert(isSameAsFullPath(chunkManager, heightMap, inConsole));
+                    }
+#endif
+                    memset(chunkManager.data + heightMap, 0, 256);
+                    chunkManager.ensureCompressed(outConsole);
+                    continue;
+                }
+            }
+
             chunkManager.readChunk(inConsole);
             if (!chunkManager.chunkData->validChunk) continue;
 
@@ -210,12 +206,18 @@ namespace editor {
             // there is probably a better way to go about this
             memset(chunkManager.chunkData->heightMap.data(), 0, 256);
 
-            chunkManager.writeChunk(outConsole);
+            if (chunkManager.writeChunk(outConsole) != SUCCESS) {
+                failed++;
+            }
             chunkManager.ensureCompressed(outConsole);
         }
 
-        fileList[regionIndex]->data.deallocate();
-        fileList[regionIndex]->data = region.write(outConsole);
+        if (failed != 0) {
+            printf("convertChunksToAquatic: %d chunks could not be written\n", failed);
+        }
+
+        Data data = region.write(outConsole);
+        fileList[regionIndex]->steal(data);
         fileList[regionIndex]->console = outConsole;
     }
 
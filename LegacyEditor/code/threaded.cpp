@@ -23,6 +23,8 @@ int run_parallel(Function func, Args... args) {
 
 template int run_parallel<4>(std::function<void(int)> func);
 
+template int run_parallel<16>(std::function<void(int)> func);
+
 template int run_parallel<4>(
         void (*)(size_t, editor::FileListing&),
         std::reference_wrapper<editor::FileListing>
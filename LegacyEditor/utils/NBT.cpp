@@ -1,110 +1,214 @@
 #include "NBT.hpp"
 
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "LegacyEditor/utils/dataReader.hpp"
+#include "LegacyEditor/utils/outputBuffer.hpp"
+
 
 static constexpr int TO_STRING_MAX_LIST_SIZE = 128;
 
 
-void NBTBase::write(DataManager& output) const {
-    switch (type) {
+template<class Writer>
+static void writeEntryWith(std::string_view name, const NBTBase& data, Writer& writer);
+
+
+/// writer is a DataWriter or BufferWriter, both are big endian.
+template<class Writer>
+static void writeWith(const NBTBase& tag, Writer& writer) {
+    c_auto* data = &tag.value;
+    switch (tag.type) {
         case NBT_INT8: {
             u8 writeVal = 0;
             std::memcpy(&writeVal, data, 1);
-            output.writeInt8(writeVal);
+            writer.writeInt8(writeVal);
             return;
         }
         case NBT_INT16: {
             i16 writeVal = 0;
             std::memcpy(&writeVal, data, 2);
-            output.writeInt16(writeVal);
+            writer.writeInt16(writeVal);
             return;
         }
         case NBT_INT32: {
             i32 writeVal = 0;
             std::memcpy(&writeVal, data, 4);
-            output.writeInt32(writeVal);
+            writer.writeInt32(writeVal);
             return;
         }
         case NBT_INT64: {
             i64 writeVal = 0;
             std::memcpy(&writeVal, data, 8);
-            output.writeInt64(writeVal);
+            writer.writeInt64(writeVal);
             return;
         }
         case NBT_FLOAT: {
             float writeVal = 0;
             std::memcpy(&writeVal, data, 4);
-            output.writeFloat(writeVal);
+            writer.writeFloat(writeVal);
             return;
         }
         case NBT_DOUBLE: {
             double writeVal = 0;
             std::memcpy(&writeVal, data, 8);
-            output.writeDouble(writeVal);
+            writer.writeDouble(writeVal);
             return;
         }
         case TAG_BYTE_ARRAY: {
-            c_auto* val = toType<NBTTagByteArray>();
-            output.writeInt32(val->size);
-            output.writeBytes(val->array, val->size);
+            c_auto* val = tag.toType<NBTTagByteArray>();
+            writer.writeInt32(val->size);
+            writer.writeBytes(val->array, val->size);
             return;
         }
         case TAG_STRING: {
-            c_auto* val = toType<NBTTagString>();
-            output.writeUTF(val->getString());
+            c_auto* val = tag.toType<NBTTagString>();
+            writer.writeInt16(static_cast<u16>(val->size));
+            writer.writeBytes(reinterpret_cast<c_u8*>(val->data), static_cast<u32>(val->size));
             return;
         }
         case TAG_LIST: {
-            c_auto* val = toType<NBTTagList>();
-            output.writeInt8(val->tagType);
-            output.writeInt32(val->tagList.size());
+            c_auto* val = tag.toType<NBTTagList>();
+            writer.writeInt8(val->tagType);
+            writer.writeInt32(val->tagList.size());
             for (c_auto& item: val->tagList) {
-                item.write(output);
+                writeWith(item, writer);
             }
             return;
         }
         case TAG_COMPOUND: {
-            auto* val = toType<NBTTagCompound>();
-            auto iter = val->tagMap.begin();
-            for (size_t sizeIter = 0; sizeIter < val->tagMap.size(); sizeIter++) {
-                NBTTagCompound::writeEntry(iter->first, iter->second, output);
-                ++iter;
+            auto* val = tag.toType<NBTTagCompound>();
+            for (c_auto& [key, value] : val->entries) {
+                writeEntryWith(key->name, value, writer);
             }
 
-            output.writeInt8(0);
+            writer.writeInt8(0);
             return;
         }
 
         case TAG_INT_ARRAY: {
-            c_auto* val = toType<NBTTagIntArray>();
-            output.writeInt32(val->size);
-            for (int sizeIter = 0; sizeIter < val->size; sizeIter++) {
-                output.writeInt32(val->array[sizeIter]);
-            }
+            c_auto* val = tag.toType<NBTTagIntArray>();
+            writer.writeInt32(val->size);
+            writer.writeArray(val->array, val->size);
             return;
         }
 
         case TAG_LONG_ARRAY: {
-            c_auto* val = toType<NBTTagLongArray>();
-            output.writeInt32(val->size);
-
-            for (int sizeIter = 0; sizeIter < val->size; sizeIter++) {
-                output.writeInt64(val->array[sizeIter]);
-            }
+            c_auto* val = tag.toType<NBTTagLongArray>();
+            writer.writeInt32(val->size);
+            writer.writeArray(val->array, val->size);
+            return;
         }
         default:;
     }
 }
 
-void NBTBase::NbtFree() const {
-    switch (type) {
+
+template<class Writer>
+static void writeEntryWith(const std::string_view name, const NBTBase& data, Writer& writer) {
+    c_int tagID = data.getId();
+    writer.writeInt8(tagID);
+    if (tagID != 0) {
+        writer.writeInt16(static_cast<u16>(name.size()));
+        writer.writeBytes(reinterpret_cast<c_u8*>(name.data()), static_cast<u32>(name.size()));
+        writeWith(data, writer);
+    }
+}
+
+
+/// the bytes writeWith writes for tag, without writing them.
+static u64 payloadSize(const NBTBase& tag) {
+    switch (tag.type) {
         case NBT_INT8:
+            return 1;
         case NBT_INT16:
+            return 2;
         case NBT_INT32:
-        case NBT_INT64:
         case NBT_FLOAT:
+            return 4;
+        case NBT_INT64:
         case NBT_DOUBLE:
-            free(this->data);
-            return;
+            return 8;
+        case TAG_BYTE_ARRAY:
+            return 4 + static_cast<u64>(tag.toType<NBTTagByteArray>()->size);
+        case TAG_INT_ARRAY:
+            return 4 + static_cast<u64>(tag.toType<NBTTagIntArray>()->size) * 4;
+        case TAG_LONG_ARRAY:
+            return 4 + static_cast<u64>(tag.toType<NBTTagLongArray>()->size) * 8;
+        case TAG_STRING:
+            return 2 + static_cast<u64>(tag.toType<NBTTagString>()->size);
+        case TAG_LIST: {
+            c_auto* val = tag.toType<NBTTagList>();
+            u64 total = 5;
+            for (c_auto& item : val->tagList) {
+                total += payloadSize(item);
+            }
+            return total;
+        }
+        case TAG_COMPOUND: {
+            c_auto* val = tag.toType<NBTTagCompound>();
+            u64 total = 1;
+            for (c_auto& [key, value] : val->entries) {
+                total += 1;
+                if (value.getId() != NBT_NONE) {
+                    total += 2 + key->name.size() + payloadSize(value);
+                }
+            }
+            return total;
+        }
+        default:
+            return 0;
+    }
+}
+
+
+void NBTBase::write(DataManager& output) const {
+    DataWriter<Endian::Big> writer(output);
+    writeWith(*this, writer);
+}
+
+
+void NBTBase::write(OutputBuffer& output) const {
+    BufferWriter<Endian::Big> writer(output);
+    writeWith(*this, writer);
+}
+
+
+/// the share count of tag's payload, or nullptr if it has none to share.
+static NBTShared* getShared(const NBTBase& tag) {
+    switch (tag.type) {
+        case TAG_BYTE_ARRAY:
+            return tag.toType<NBTTagByteArray>();
+        case TAG_STRING:
+            return tag.toType<NBTTagString>();
+        case TAG_LIST:
+            return tag.toType<NBTTagList>();
+        case TAG_COMPOUND:
+            return tag.toType<NBTTagCompound>();
+        case TAG_INT_ARRAY:
+            return tag.toType<NBTTagIntArray>();
+        case TAG_LONG_ARRAY:
+            return tag.toType<NBTTagLongArray>();
+        default:
+            return nullptr;
+    }
+}
+
+
+void NBTBase::NbtFree() const {
+    // the arena frees it, primitives have nothing to free
+    if (isArenaOwned) {
+        return;
+    }
+    // the count is of the other holders, so whoever finds it at 0 is the last
+    if (NBTShared* shared = getShared(*this); shared != nullptr
+        && std::atomic_ref(shared->shareCount).fetch_sub(1, std::memory_order_acq_rel) != 0) {
+        return;
+    }
+    switch (type) {
         case TAG_BYTE_ARRAY: {
             c_auto* val = toType<NBTTagByteArray>();
             free(val->array);
@@ -151,32 +255,32 @@ std::string NBTBase::toString() const {
             return "END";
         case NBT_INT8: {
             u8 val = 0;
-            std::memcpy(&val, this->data, 1);
+            std::memcpy(&val, &value, 1);
             return std::to_string(val) + "b";
         }
         case NBT_INT16: {
             i16 val = 0;
-            std::memcpy(&val, this->data, 2);
+            std::memcpy(&val, &value, 2);
             return std::to_string(val) + "s";
         }
         case NBT_INT32: {
             i32 val = 0;
-            std::memcpy(&val, this->data, 4);
+            std::memcpy(&val, &value, 4);
             return std::to_string(val);
         }
         case NBT_INT64: {
             i64 val = 0;
-            std::memcpy(&val, this->data, 8);
+            std::memcpy(&val, &value, 8);
             return std::to_string(val) + "L";
         }
         case NBT_FLOAT: {
             float val = 0;
-            std::memcpy(&val, this->data, 4);
+            std::memcpy(&val, &value, 4);
             return std::to_string(val) + "f";
         }
         case NBT_DOUBLE: {
             double val = 0;
-            std::memcpy(&val, this->data, 8);
+            std::memcpy(&val, &value, 8);
             return std::to_string(val) + "d";
         }
         case TAG_BYTE_ARRAY: {
@@ -216,11 +320,11 @@ std::string NBTBase::toString() const {
             auto* val = toType<NBTTagCompound>();
             std::string stringBuilder = "{";
 
-            for (const std::string& str: val->getKeySet()) {
+            for (c_auto& [key, tag]: val->entries) {
                 if (stringBuilder.length() != 1) { stringBuilder.append(", "); }
-                stringBuilder.append(str);
+                stringBuilder.append(key->name);
                 stringBuilder.append(": ");
-                stringBuilder.append(val->tagMap.at(str).toString());
+                stringBuilder.append(tag.toString());
             }
             stringBuilder.push_back('}');
             return stringBuilder;
@@ -245,12 +349,14 @@ std::string NBTBase::toString() const {
             c_auto* val = toType<NBTTagLongArray>();
             std::string stringBuilder = "[L;";
 
-            for (size_t i = 0; i < stringBuilder.length(); ++i) {
+            for (int i = 0; i < std::min(TO_STRING_MAX_LIST_SIZE, val->size); ++i) {
                 if (i != 0) { stringBuilder.append(", "); }
-
                 stringBuilder.append(std::to_string(val->array[i]));
             }
-            stringBuilder.append("]");
+            if (val->size > TO_STRING_MAX_LIST_SIZE) {
+                stringBuilder.append("...");
+            }
+            stringBuilder.push_back(']');
             return stringBuilder;
         }
         default:
@@ -259,64 +365,59 @@ std::string NBTBase::toString() const {
 }
 
 
-void NBTBase::read(DataManager& input) {
+/// heap memory is malloc'd, as NbtFree free()s it.
+static void* allocateIn(NBTArena* theArena, c_u64 theSize, c_u64 theAlign) {
+    return theArena != nullptr ? theArena->allocate(theSize, theAlign) : malloc(theSize);
+}
+
+
+void NBTBase::read(DataManager& input, NBTArena* theArena, c_bool isBorrowingBytes) {
+    DataReader<Endian::Big> reader(input);
     switch (type) {
-        case NBT_INT8: {
-            c_u8 readData = input.readInt8();
-            data = malloc(1);
-            std::memcpy(data, &readData, 1);
+        case NBT_INT8:
+            setValue(static_cast<u8>(reader.readInt8()));
             return;
-        }
-        case NBT_INT16: {
-            c_auto readData = static_cast<i16>(input.readInt16());
-            data = malloc(2);
-            std::memcpy(data, &readData, 2);
+        case NBT_INT16:
+            setValue(static_cast<i16>(reader.readInt16()));
             return;
-        }
-        case NBT_INT32: {
-            c_auto readData = static_cast<i32>(input.readInt32());
-            data = malloc(4);
-            std::memcpy(data, &readData, 4);
+        case NBT_INT32:
+            setValue(static_cast<i32>(reader.readInt32()));
             return;
-        }
-        case NBT_INT64: {
-            c_auto readData = static_cast<i64>(input.readInt64());
-            data = malloc(8);
-            std::memcpy(data, &readData, 8);
+        case NBT_INT64:
+            setValue(static_cast<i64>(reader.readInt64()));
             return;
-        }
-        case NBT_FLOAT: {
-            const float readData = input.readFloat();
-            data = malloc(4);
-            std::memcpy(data, &readData, 4);
+        case NBT_FLOAT:
+            setValue(reader.readFloat());
             return;
-        }
-        case NBT_DOUBLE: {
-            const double readData = input.readDouble();
-            data = malloc(8);
-            std::memcpy(data, &readData, 8);
+        case NBT_DOUBLE:
+            setValue(reader.readDouble());
             return;
-        }
         case TAG_BYTE_ARRAY: {
             auto* val = toType<NBTTagByteArray>();
-            c_auto num = static_cast<int>(input.readInt32());
-            val->array = input.readBytes(num);
+            c_auto num = static_cast<int>(reader.readInt32());
+            // heap trees own their arrays, as NbtFree free()s them
+            if (theArena != nullptr && isBorrowingBytes) {
+                val->array = input.ptr;
+                input.incrementPointer(num);
+            } else {
+                val->array = static_cast<u8*>(allocateIn(theArena, num, 1));
+                reader.readBytes(num, val->array);
+            }
             val->size = num;
             return;
         }
         case TAG_STRING: {
             auto* val = toType<NBTTagString>();
-            const std::string inputString = input.readUTF();
-            c_int size = static_cast<int>(inputString.size());
-            val->data = static_cast<char*>(malloc(size));
-            std::memcpy(val->data, inputString.c_str(), size);
+            c_u16 size = reader.readInt16();
+            val->data = static_cast<char*>(allocateIn(theArena, size, 1));
+            reader.readBytes(size, reinterpret_cast<u8*>(val->data));
             val->size = size;
             return;
         }
         case TAG_LIST: {
             auto* val = toType<NBTTagList>();
-            val->tagType = static_cast<NBTType>(input.readInt8());
-            c_auto size = static_cast<int>(input.readInt32());
+            val->tagType = static_cast<NBTType>(reader.readInt8());
+            c_auto size = static_cast<int>(reader.readInt32());
             if (size == 0) {
                 //this prevents the old NBT style where empty list tags would be of type 1 (byte)
                 //and then items other than byte tags cannot be added onto it
@@ -326,13 +427,10 @@ void NBTBase::read(DataManager& input) {
                 printf("Missing type on ListTag");
 
             } else {
+                val->tagList.reserve(size);
                 for (int j = 0; j < size; ++j) {
-                    NBTBase* nbtBase = createNewByType(val->tagType);
-                    nbtBase->read(input);
-                    val->tagList.push_back(*nbtBase);
-                    //free the base data (the data and the type), the rest is allocated
-                    // and this is copied when pushed back so that is why we free it
-                    delete nbtBase;
+                    NBTBase& nbtBase = val->tagList.emplace_back(makeByType(val->tagType, theArena));
+                    nbtBase.read(input, theArena, isBorrowingBytes);
                 }
             }
             return;
@@ -341,33 +439,35 @@ void NBTBase::read(DataManager& input) {
             auto* val = toType<NBTTagCompound>();
             u8 byte;
 
-            while (byte = input.readInt8(), byte != 0) {
-                std::string str = input.readUTF();
-                const NBTBase* nbtBase = NBT::readNBT(static_cast<NBTType>(byte), str, input);
-                val->tagMap[str] = *nbtBase;
-                delete nbtBase;
+            while (byte = reader.readInt8(), byte != 0) {
+                c_u16 keySize = reader.readInt16();
+                c_auto* key = NBTKeys::intern({reinterpret_cast<const char*>(input.ptr), keySize});
+                input.incrementPointer(keySize);
+
+                NBTBase nbtBase = makeByType(static_cast<NBTType>(byte), theArena);
+                nbtBase.read(input, theArena, isBorrowingBytes);
+                if (NBTBase* existing = val->find(key); existing != nullptr) {
+                    existing->NbtFree();
+                    *existing = nbtBase;
+                } else {
+                    val->entries.push_back({key, nbtBase});
+                }
             }
             return;
         }
         case TAG_INT_ARRAY: {
             auto* val = toType<NBTTagIntArray>();
-            c_int size = static_cast<int>(input.readInt32());
-            val->array = static_cast<int*>(malloc(size * 4)); // i * size of int
-
-            for (int j = 0; j < size; ++j) {
-                val->array[j] = static_cast<int>(input.readInt32());
-            }
+            c_int size = static_cast<int>(reader.readInt32());
+            val->array = static_cast<int*>(allocateIn(theArena, size * 4, alignof(int))); // i * size of int
+            reader.readArray(val->array, size);
             val->size = size;
             return;
         }
         case TAG_LONG_ARRAY: {
             auto* val = toType<NBTTagLongArray>();
-            c_int size = static_cast<int>(input.readInt32());
-            val->array = static_cast<i64*>(malloc(size * 8)); // i * size of long
-
-            for (int j = 0; j < size; ++j) {
-                val->array[j] = static_cast<int>(input.readInt64());
-            }
+            c_int size = static_cast<int>(reader.readInt32());
+            val->array = static_cast<i64*>(allocateIn(theArena, size * 8, alignof(i64))); // i * size of long
+            reader.readArray(val->array, size);
             val->size = size;
         }
         default:;
@@ -375,84 +475,74 @@ void NBTBase::read(DataManager& input) {
 }
 
 
-NBTBase NBTBase::copy() const {
+NBTBase NBTBase::copy(NBTArena* theArena) const {
     switch (type) {
-        case NBT_INT8: {
-            auto* copyData = static_cast<u8*>(malloc(1));
-            std::memcpy(copyData, data, 1);
-            return {copyData, type};
-        }
-        case NBT_INT16: {
-            auto* copyData = static_cast<i16*>(malloc(2));
-            std::memcpy(copyData, data, 2);
-            return {copyData, type};
-        }
-        case NBT_INT32: {
-            auto* copyData = static_cast<i32*>(malloc(4));
-            std::memcpy(copyData, data, 4);
-            return {copyData, type};
-        }
-        case NBT_INT64: {
-            auto* copyData = static_cast<i64*>(malloc(8));
-            std::memcpy(copyData, data, 8);
-            return {copyData, type};
-        }
-        case NBT_FLOAT: {
-            auto* copyData = static_cast<float*>(malloc(4));
-            std::memcpy(copyData, data, 4);
-            return {copyData, type};
-        }
-        case NBT_DOUBLE: {
-            auto* copyData = static_cast<double*>(malloc(8));
-            std::memcpy(copyData, data, 8);
-            return {copyData, type};
-        }
+        case NBT_INT8:
+        case NBT_INT16:
+        case NBT_INT32:
+        case NBT_INT64:
+        case NBT_FLOAT:
+        case NBT_DOUBLE:
+            return {&value, sizeof(value), type};
         case TAG_BYTE_ARRAY: {
             c_auto* val = toType<NBTTagByteArray>();
-            c_int size = val->size;
-            auto* aByte = static_cast<u8*>(malloc(size));
-            std::memcpy(aByte, val->array, size);
-            return {new NBTTagByteArray(aByte, size), TAG_BYTE_ARRAY};
+            NBTBase copied = makeByType(type, theArena);
+            auto* copiedVal = copied.toType<NBTTagByteArray>();
+            copiedVal->array = static_cast<u8*>(allocateIn(theArena, val->size, 1));
+            copiedVal->size = val->size;
+            std::memcpy(copiedVal->array, val->array, val->size);
+            return copied;
         }
         case TAG_STRING: {
             c_auto* val = toType<NBTTagString>();
-            c_auto copied = NBTBase(new NBTTagString(val->getString()), TAG_STRING);
+            NBTBase copied = makeByType(type, theArena);
+            auto* copiedVal = copied.toType<NBTTagString>();
+            copiedVal->data = static_cast<char*>(allocateIn(theArena, val->size, 1));
+            copiedVal->size = val->size;
+            std::memcpy(copiedVal->data, val->data, val->size);
             return copied;
         }
         case TAG_LIST: {
             c_auto* val = toType<NBTTagList>();
-            auto* pNbtTagList = new NBTTagList();
+            NBTBase copied = makeByType(type, theArena);
+            auto* pNbtTagList = copied.toType<NBTTagList>();
             pNbtTagList->tagType = val->tagType;
+            pNbtTagList->tagList.reserve(val->tagList.size());
 
-            for (NBTBase nbtBase: val->tagList) {
-                NBTBase nbtBase1 = nbtBase.copy();
-                pNbtTagList->tagList.push_back(nbtBase1);
+            for (const NBTBase& nbtBase: val->tagList) {
+                pNbtTagList->tagList.push_back(nbtBase.copy(theArena));
             }
-
-            return {pNbtTagList, TAG_LIST};
+            return copied;
         }
         case TAG_COMPOUND: {
             auto* val = toType<NBTTagCompound>();
-            auto* pNbtTagCompound = new NBTTagCompound();
-            for (const std::vector<std::string> keySet = val->getKeySet(); const std::string& str: keySet) {
-                pNbtTagCompound->setTag(str, val->tagMap.at(str).copy());
+            NBTBase copied = makeByType(type, theArena);
+            auto* pNbtTagCompound = copied.toType<NBTTagCompound>();
+            pNbtTagCompound->entries.reserve(val->entries.size());
+            for (c_auto& [key, tag]: val->entries) {
+                pNbtTagCompound->entries.push_back({key, tag.copy(theArena)});
             }
-
-            return {pNbtTagCompound, TAG_COMPOUND};
+            return copied;
         }
         case TAG_INT_ARRAY: {
             c_auto* val = toType<NBTTagIntArray>();
-            c_int size = val->size * 4;
-            auto* const anInt = static_cast<int*>(malloc(size)); //size is in the number of ints
-            std::memcpy(anInt, val->array, size);
-            return {new NBTTagIntArray(anInt, val->size), TAG_INT_ARRAY};
+            NBTBase copied = makeByType(type, theArena);
+            auto* copiedVal = copied.toType<NBTTagIntArray>();
+            c_int size = val->size * 4; //size is in the number of ints
+            copiedVal->array = static_cast<int*>(allocateIn(theArena, size, alignof(int)));
+            copiedVal->size = val->size;
+            std::memcpy(copiedVal->array, val->array, size);
+            return copied;
         }
         case TAG_LONG_ARRAY: {
             c_auto* val = toType<NBTTagLongArray>();
+            NBTBase copied = makeByType(type, theArena);
+            auto* copiedVal = copied.toType<NBTTagLongArray>();
             c_int size = val->size * 8; // size is in the number of longs
-            auto* along = static_cast<i64*>(malloc(size));
-            std::memcpy(along, val->array, size);
-            return {new NBTTagLongArray(along, val->size), TAG_LONG_ARRAY};
+            copiedVal->array = static_cast<i64*>(allocateIn(theArena, size, alignof(i64)));
+            copiedVal->size = val->size;
+            std::memcpy(copiedVal->array, val->array, size);
+            return copied;
         }
         case NBT_NONE:
         default:
@@ -460,63 +550,223 @@ NBTBase NBTBase::copy() const {
     }
 }
 
+NBTBase NBTBase::share() const {
+    NBTShared* shared = getShared(*this);
+    if (isArenaOwned || shared == nullptr) {
+        return copy();
+    }
+    std::atomic_ref(shared->shareCount).fetch_add(1, std::memory_order_relaxed);
+    return {data, type};
+}
+
+
+bool NBTBase::isShared() const {
+    NBTShared* shared = getShared(*this);
+    return !isArenaOwned && shared != nullptr
+           && std::atomic_ref(shared->shareCount).load(std::memory_order_acquire) != 0;
+}
+
+
+NBTBase& NBTBase::makeUnique() {
+    if (!isShared()) {
+        return *this;
+    }
+    NBTBase unique;
+    switch (type) {
+        case TAG_LIST: {
+            c_auto* val = toType<NBTTagList>();
+            unique = makeByType(type);
+            auto* uniqueVal = unique.toType<NBTTagList>();
+            uniqueVal->tagType = val->tagType;
+            uniqueVal->tagList.reserve(val->tagList.size());
+            for (const NBTBase& item: val->tagList) {
+                uniqueVal->tagList.push_back(item.share());
+            }
+            break;
+        }
+        case TAG_COMPOUND: {
+            c_auto* val = toType<NBTTagCompound>();
+            unique = makeByType(type);
+            auto* uniqueVal = unique.toType<NBTTagCompound>();
+            uniqueVal->entries.reserve(val->entries.size());
+            for (c_auto& [key, tag]: val->entries) {
+                uniqueVal->entries.push_back({key, tag.share()});
+            }
+            break;
+        }
+        default:
+            // strings and arrays have no children to share
+            unique = copy();
+            break;
+    }
+    NbtFree();
+    *this = unique;
+    return *this;
+}
+
+
+void NBTArena::adopt(NBTBase& theTag) {
+    myAdopted.push_back(theTag);
+    theTag.isArenaOwned = true;
+}
+
+
+void NBTArena::release() {
+    for (const NBTBase& tag: myAdopted) {
+        tag.NbtFree();
+    }
+    myAdopted.clear();
+    myResource.release();
+}
+
+
+const NBTKeyName* NBTKeys::intern(const std::string_view theName, c_u32 theHash) {
+    struct Hasher {
+        size_t operator()(const NBTKeyName& theKey) const { return theKey.hash; }
+    };
+    struct Equal {
+        bool operator()(const NBTKeyName& first, const NBTKeyName& second) const {
+            return first.hash == second.hash && first.name == second.name;
+        }
+    };
+    using RecordMap = std::unordered_map<NBTKeyName, const NBTKeyName*, Hasher, Equal>;
+
+    // keys are looked up far more often than they are new, so readers share the lock
+    static std::shared_mutex mutex;
+    static RecordMap records = [] {
+        RecordMap common;
+        for (const NBTKeyName& key : NBT_COMMON_KEYS) {
+            common.emplace(key, &key);
+        }
+        return common;
+    }();
+    // deques never move what they hold, so the records and names stay put
+    static std::deque<std::string> names;
+    static std::deque<NBTKeyName> made;
+
+    const NBTKeyName lookup{theName, theHash};
+    {
+        std::shared_lock lock(mutex);
+        if (c_auto iter = records.find(lookup); iter != records.end()) {
+            return iter->second;
+        }
+    }
+
+    std::unique_lock lock(mutex);
+    if (c_auto iter = records.find(lookup); iter != records.end()) {
+        return iter->second;
+    }
+    const std::string& name = names.emplace_back(theName);
+    const NBTKeyName* record = &made.emplace_back(NBTKeyName{name, theHash});
+    records.emplace(*record, record);
+    return record;
+}
+
+
 /// I don't think this is necessary, but if it is then I'll do it.
 /// It just is in the java code but never used
 MU bool NBTBase::equals(MU NBTBase check) { return false; }
 
 
-void NBTTagCompound::writeEntry(const std::string& name, const NBTBase data, DataManager& output) {
-    c_int tagID = data.getId();
-    output.writeInt8(tagID);
-    if (tagID != 0) {
-        output.writeUTF(name);
-        data.write(output);
-    }
+void NBTTagCompound::writeEntry(const std::string_view name, const NBTBase data, DataManager& output) {
+    DataWriter<Endian::Big> writer(output);
+    writeEntryWith(name, data, writer);
+}
+
+
+void NBTTagCompound::writeEntry(const std::string_view name, const NBTBase data, OutputBuffer& output) {
+    BufferWriter<Endian::Big> writer(output);
+    writeEntryWith(name, data, writer);
 }
 
 
 std::vector<std::string> NBTTagCompound::getKeySet() {
     std::vector<std::string> keySet;
-    auto iter = tagMap.begin();
-    c_int size = static_cast<int>(tagMap.size());
-    for (int sizeIter = 0; sizeIter < size; sizeIter++) {
-        keySet.push_back(iter->first);
-        ++iter;
+    keySet.reserve(entries.size());
+    for (c_auto& [key, tag]: entries) {
+        keySet.emplace_back(key->name);
     }
     return keySet;
 }
 
 
-int NBTTagCompound::getSize() const { return static_cast<int>(tagMap.size()); }
+int NBTTagCompound::getSize() const { return static_cast<int>(entries.size()); }
+
+
+static bool isOfType(const NBTBase* tag, c_int type) {
+    return tag->getId() == type
+           || (type == TAG_PRIMITIVE && tag->getId() >= NBT_INT8 && tag->getId() <= NBT_DOUBLE);
+}
+
+
+NBTBase* NBTTagCompound::findEntry(const NBTKey& key) const {
+    for (const Entry& entry: entries) {
+        if (key.matches(entry.key)) { return const_cast<NBTBase*>(&entry.tag); }
+    }
+    return nullptr;
+}
 
 
-void NBTTagCompound::setTag(const std::string& key, const NBTBase value) {
-    if (tagMap.contains(key)) { tagMap[key].NbtFree(); }
-    tagMap[key] = value;
+NBTBase* NBTTagCompound::find(const NBTKey& key) {
+    NBTBase* tag = findEntry(key);
+    if (tag != nullptr) {
+        tag->makeUnique();
+    }
+    return tag;
 }
 
 
-void NBTTagCompound::setByte(const std::string& key, u8 value) {
-    if (tagMap.contains(key)) { tagMap[key].NbtFree(); }
-    tagMap[key] = NBTBase(&value, 1, NBT_INT8);
+const NBTBase* NBTTagCompound::find(const NBTKey& key) const {
+    return findEntry(key);
 }
 
 
-void NBTTagCompound::setShort(const std::string& key, short value) {
-    if (tagMap.contains(key)) { tagMap[key].NbtFree(); }
-    tagMap[key] = NBTBase(&value, 2, NBT_INT16);
+NBTBase* NBTTagCompound::findOfType(const NBTKey& key, c_int type) {
+    NBTBase* tag = findEntry(key);
+    if (tag == nullptr || !isOfType(tag, type)) {
+        return nullptr;
+    }
+    tag->makeUnique();
+    return tag;
 }
 
 
-void NBTTagCompound::setInteger(const std::string& key, int value) {
-    if (tagMap.contains(key)) { tagMap[key].NbtFree(); }
-    tagMap[key] = NBTBase(&value, 4, NBT_INT32);
+void NBTTagCompound::put(const NBTKey& key, NBTBase value) {
+    // a heap tag set into an arena compound is freed with the arena
+    if (arena != nullptr && !value.isArenaOwned) {
+        arena->adopt(value);
+    }
+    if (NBTBase* existing = findEntry(key); existing != nullptr) {
+        existing->NbtFree();
+        *existing = value;
+        return;
+    }
+    entries.push_back({key.interned != nullptr ? key.interned : NBTKeys::intern(key.name, key.hash), value});
 }
 
 
-void NBTTagCompound::setLong(const std::string& key, i64 value) {
-    if (tagMap.contains(key)) { tagMap[key].NbtFree(); }
-    tagMap[key] = NBTBase(&value, 8, NBT_INT64);
+void NBTTagCompound::setTag(const NBTKey& key, const NBTBase value) {
+    put(key, value);
+}
+
+
+void NBTTagCompound::setByte(const NBTKey& key, u8 value) {
+    put(key, NBTBase(&value, 1, NBT_INT8));
+}
+
+
+void NBTTagCompound::setShort(const NBTKey& key, short value) {
+    put(key, NBTBase(&value, 2, NBT_INT16));
+}
+
+
+void NBTTagCompound::setInteger(const NBTKey& key, int value) {
+    put(key, NBTBase(&value, 4, NBT_INT32));
+}
+
+
+void NBTTagCompound::setLong(const NBTKey& key, i64 value) {
+    put(key, NBTBase(&value, 8, NBT_INT64));
 }
 
 /*
@@ -531,211 +781,190 @@ UUIDJava NBTTagCompound::getUniqueId(const std::string& key) {
 }
 */
 
-bool NBTTagCompound::hasUniqueId(const std::string& key) {
-    return hasKey(key + "Most", TAG_PRIMITIVE) && hasKey(key + "Least", TAG_PRIMITIVE);
+bool NBTTagCompound::hasUniqueId(const NBTKey& key) {
+    const std::string keyStr(key.name);
+    return hasKey(keyStr + "Most", TAG_PRIMITIVE) && hasKey(keyStr + "Least", TAG_PRIMITIVE);
 }
 
 
-void NBTTagCompound::setFloat(const std::string& key, float value) {
-    if (tagMap.contains(key)) { tagMap[key].NbtFree(); }
-    tagMap[key] = NBTBase(&value, 4, NBT_FLOAT);
+void NBTTagCompound::setFloat(const NBTKey& key, float value) {
+    put(key, NBTBase(&value, 4, NBT_FLOAT));
 }
 
 
-void NBTTagCompound::setDouble(const std::string& key, double value) {
-    if (tagMap.contains(key)) { tagMap[key].NbtFree(); }
-    tagMap[key] = NBTBase(&value, 8, NBT_DOUBLE);
+void NBTTagCompound::setDouble(const NBTKey& key, double value) {
+    put(key, NBTBase(&value, 8, NBT_DOUBLE));
 }
 
 
-void NBTTagCompound::setString(const std::string& key, const std::string& value) {
-    if (tagMap.contains(key)) { tagMap[key].NbtFree(); }
-    tagMap[key] = NBTBase(new NBTTagString(value), TAG_STRING);
+void NBTTagCompound::setString(const NBTKey& key, const std::string_view value) {
+    NBTBase tag = makeByType(TAG_STRING, arena);
+    *tag.toType<NBTTagString>() = NBTTagString(value, arena);
+    put(key, tag);
 }
 
-void NBTTagCompound::setByteArray(const std::string& key, c_u8* value, c_int size) {
-    if (tagMap.contains(key)) { tagMap[key].NbtFree(); }
-    auto* data = static_cast<u8*>(malloc(size)); // so the original can be safely deleted
+void NBTTagCompound::setByteArray(const NBTKey& key, c_u8* value, c_int size) {
+    NBTBase tag = makeByType(TAG_BYTE_ARRAY, arena);
+    auto* data = static_cast<u8*>(allocateIn(arena, size, 1)); // so the original can be safely deleted
     std::memcpy(data, value, size);
-    tagMap[key] = NBTBase(new NBTTagByteArray(data, size), TAG_BYTE_ARRAY);
+    *tag.toType<NBTTagByteArray>() = NBTTagByteArray(data, size);
+    put(key, tag);
 }
 
 
-void NBTTagCompound::setIntArray(const std::string& key, c_int* value, c_int size) {
-    if (tagMap.contains(key)) { tagMap[key].NbtFree(); }
-    auto* const data = static_cast<int*>(malloc(size * 4)); // so the original can be safely deleted
+void NBTTagCompound::setIntArray(const NBTKey& key, c_int* value, c_int size) {
+    NBTBase tag = makeByType(TAG_INT_ARRAY, arena);
+    auto* const data = static_cast<int*>(allocateIn(arena, size * 4, alignof(int))); // so the original can be safely deleted
     std::memcpy(data, value, size * 4);
-    tagMap[key] = NBTBase(new NBTTagIntArray(data, size), TAG_INT_ARRAY);
+    *tag.toType<NBTTagIntArray>() = NBTTagIntArray(data, size);
+    put(key, tag);
 }
 
 
-void NBTTagCompound::setLongArray(const std::string& key, const i64* value, c_int size) {
-    if (tagMap.contains(key)) { tagMap[key].NbtFree(); }
-    auto* data = static_cast<i64*>(malloc(size * 8)); //so the original can be safely deleted
+void NBTTagCompound::setLongArray(const NBTKey& key, const i64* value, c_int size) {
+    NBTBase tag = makeByType(TAG_LONG_ARRAY, arena);
+    auto* data = static_cast<i64*>(allocateIn(arena, size * 8, alignof(i64))); //so the original can be safely deleted
     std::memcpy(data, value, size * 8);                    //the endianness is maintained because it is copied raw
-    tagMap[key] = NBTBase(new NBTTagLongArray(data, size), TAG_LONG_ARRAY);
+    *tag.toType<NBTTagLongArray>() = NBTTagLongArray(data, size);
+    put(key, tag);
 }
 
 
-void NBTTagCompound::setCompoundTag(const std::string& key, NBTTagCompound* compoundTag) {
-    if (tagMap.contains(key)) { tagMap[key].NbtFree(); }
-    tagMap[key] = NBTBase(compoundTag, TAG_COMPOUND);
+void NBTTagCompound::setCompoundTag(const NBTKey& key, NBTTagCompound* compoundTag) {
+    put(key, NBTBase(compoundTag, TAG_COMPOUND));
 }
 
 
-void NBTTagCompound::setListTag(const std::string& key, NBTTagList* listTag) {
-    if (tagMap.contains(key)) { tagMap[key].NbtFree(); }
-    tagMap[key] = NBTBase(listTag, TAG_LIST);
+void NBTTagCompound::setListTag(const NBTKey& key, NBTTagList* listTag) {
+    put(key, NBTBase(listTag, TAG_LIST));
 }
 
 
-void NBTTagCompound::setBool(const std::string& key, u8 value) {
-    if (tagMap.contains(key)) { tagMap[key].NbtFree(); }
+void NBTTagCompound::setBool(const NBTKey& key, u8 value) {
     value = value != 0U ? 1 : 0;
-    tagMap[key] = NBTBase(&value, 1, NBT_INT8);
+    put(key, NBTBase(&value, 1, NBT_INT8));
+}
+
+
+NBTBase NBTTagCompound::getTag(const NBTKey& key) {
+    if (c_auto* tag = find(key); tag != nullptr) { return *tag; }
+    return {};
 }
 
 
-NBTBase NBTTagCompound::getTag(const std::string& key) {
-    if (c_auto iter = tagMap.find(key); iter != tagMap.end()) { return iter->second; }
+NBTBase NBTTagCompound::extractTag(const NBTKey& key) {
+    for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
+        if (key.matches(iter->key)) {
+            const NBTBase tag = iter->tag;
+            entries.erase(iter);
+            return tag;
+        }
+    }
     return {};
 }
 
 
-NBTType NBTTagCompound::getTagId(const std::string& key) {
-    const NBTBase nbtBase = getTag(key);
-    return nbtBase.getId();
+NBTType NBTTagCompound::getTagId(const NBTKey& key) {
+    c_auto* tag = findEntry(key);
+    return tag != nullptr ? tag->getId() : NBT_NONE;
 }
 
 
 void NBTTagCompound::deleteAll() {
-    for (auto& [fst, snd]: tagMap) { snd.NbtFree(); }
-    tagMap.clear();
+    for (c_auto& [key, tag]: entries) { tag.NbtFree(); }
+    entries.clear();
 }
 
 
-bool NBTTagCompound::hasKey(const std::string& key) const {
-    if (tagMap.empty()) {
-        return false;
-    }
-    if (tagMap.contains(key)) {
-        return true;
-    }
-    return false;
+bool NBTTagCompound::hasKey(const NBTKey& key) const {
+    return find(key) != nullptr;
 }
 
 
-bool NBTTagCompound::hasKey(const std::string& key, c_int type) {
-    if (hasKey(key)) {
-        c_int tagID = getTagId(key);
-        if (tagID == type) {
-            return true;
-        }
-        if (type != TAG_PRIMITIVE) {
-            return false;
-        }
-        return tagID == 1 || tagID == 2 || tagID == 3 || tagID == 4 || tagID == 5 || tagID == 6;
-    }
-    return false;
+bool NBTTagCompound::hasKey(const NBTKey& key, c_int type) {
+    c_auto* tag = findEntry(key);
+    return tag != nullptr && isOfType(tag, type);
 }
 
 
-bool NBTTagCompound::hasKey(const std::string& key, const NBTType type) {
-    if (hasKey(key)) {
-        c_int tagID = getTagId(key);
-        if (tagID == type) {
-            return true;
-        }
-        if (type != TAG_PRIMITIVE) {
-            return false;
-        }
-        return tagID == 1 || tagID == 2 || tagID == 3 || tagID == 4 || tagID == 5 || tagID == 6;
-    }
-    return false;
+bool NBTTagCompound::hasKey(const NBTKey& key, const NBTType type) {
+    return hasKey(key, static_cast<int>(type));
 }
 
 
-std::string NBTTagCompound::getString(const std::string& key) {
-    if (hasKey(key, TAG_STRING)) {
-        return NBTBase::toType<NBTTagString>(tagMap.at(key))->getString();
+std::string NBTTagCompound::getString(const NBTKey& key) {
+    // only read, so a shared string is not copied
+    if (c_auto* tag = findEntry(key); tag != nullptr && tag->getId() == TAG_STRING) {
+        return tag->toType<NBTTagString>()->getString();
     }
     return "";
 }
 
 
-NBTTagByteArray* NBTTagCompound::getByteArray(const std::string& key) {
-    if (hasKey(key, TAG_BYTE_ARRAY)) {
-        const NBTBase byteArrayBase = tagMap.at(key);
-        return NBTBase::toType<NBTTagByteArray>(byteArrayBase);
+NBTTagByteArray* NBTTagCompound::getByteArray(const NBTKey& key) {
+    if (c_auto* tag = findOfType(key, TAG_BYTE_ARRAY)) {
+        return tag->toType<NBTTagByteArray>();
     }
     return nullptr;
 }
 
 
-NBTTagIntArray* NBTTagCompound::getIntArray(const std::string& key) {
-    if (hasKey(key, TAG_INT_ARRAY)) {
-        const NBTBase intArrayBase = tagMap.at(key);
-        return NBTBase::toType<NBTTagIntArray>(intArrayBase);
+NBTTagIntArray* NBTTagCompound::getIntArray(const NBTKey& key) {
+    if (c_auto* tag = findOfType(key, TAG_INT_ARRAY)) {
+        return tag->toType<NBTTagIntArray>();
     }
     return nullptr;
 }
 
 
-NBTTagLongArray* NBTTagCompound::getLongArray(const std::string& key) {
-    if (hasKey(key, TAG_LONG_ARRAY)) {
-        const NBTBase longArrayBase = tagMap.at(key);
-        return NBTBase::toType<NBTTagLongArray>(longArrayBase);
+NBTTagLongArray* NBTTagCompound::getLongArray(const NBTKey& key) {
+    if (c_auto* tag = findOfType(key, TAG_LONG_ARRAY)) {
+        return tag->toType<NBTTagLongArray>();
     }
     return nullptr;
 }
 
 
-NBTTagCompound* NBTTagCompound::getCompoundTag(const std::string& key) {
-    if (hasKey(key, TAG_COMPOUND)) {
-        const NBTBase base = tagMap.at(key);
-        return NBTBase::toType<NBTTagCompound>(base);
+NBTTagCompound* NBTTagCompound::getCompoundTag(const NBTKey& key) {
+    if (c_auto* tag = findOfType(key, TAG_COMPOUND)) {
+        return tag->toType<NBTTagCompound>();
     }
     return nullptr;
 }
 
 
-NBTTagList* NBTTagCompound::getListTag(const std::string& key) {
-    if (hasKey(key, TAG_LIST)) {
-        return NBTBase::toType<NBTTagList>(tagMap.at(key));
+NBTTagList* NBTTagCompound::getListTag(const NBTKey& key) {
+    if (c_auto* tag = findOfType(key, TAG_LIST)) {
+        return tag->toType<NBTTagList>();
     }
     return nullptr;
 }
 
 
-bool NBTTagCompound::getBool(const std::string& key) { return getPrimitive<bool>(key); }
+bool NBTTagCompound::getBool(const NBTKey& key) { return getPrimitive<bool>(key); }
 
 
-void NBTTagCompound::removeTag(const std::string& key) {
-    if (!hasKey(key)) { return; }
-    tagMap.at(key).NbtFree();
-    tagMap.erase(key);
+void NBTTagCompound::removeTag(const NBTKey& key) {
+    for (auto iter = entries.begin(); iter != entries.end(); ++iter) {
+        if (key.matches(iter->key)) {
+            iter->tag.NbtFree();
+            entries.erase(iter);
+            return;
+        }
+    }
 }
 
 
-MU bool NBTTagCompound::hasNoTags() const { return tagMap.empty(); }
+MU bool NBTTagCompound::hasNoTags() const { return entries.empty(); }
 
 
 void NBTTagCompound::merge(NBTTagCompound* other) {
-    auto iter = other->tagMap.begin();
-    c_int size = static_cast<int>(other->tagMap.size());
-    for (int x = 0; x < size; x++) {
-        std::string key = iter->first;
-        if (NBTBase nbtBase = iter->second; nbtBase.getId() == TAG_COMPOUND) {
-            if (hasKey(key, TAG_COMPOUND)) {
-                NBTTagCompound* pNbtTagCompound = getCompoundTag(key);
-                pNbtTagCompound->merge(NBTBase::toType<NBTTagCompound>(nbtBase));
-            } else {
-                setTag(key, nbtBase.copy());
-            }
+    for (c_auto& [key, nbtBase]: other->entries) {
+        if (NBTBase* mine = findOfType(key, TAG_COMPOUND); mine != nullptr && nbtBase.getId() == TAG_COMPOUND) {
+            mine->toType<NBTTagCompound>()->merge(NBTBase::toType<NBTTagCompound>(nbtBase));
         } else {
-            setTag(key, nbtBase.copy());
+            setTag(key, nbtBase.copy(arena));
         }
-        ++iter;
     }
 }
 
@@ -794,11 +1023,10 @@ NBTBase NBTTagList::get(c_u32 index) const {
 }
 
 
-NBTTagByteArray* NBTTagList::getByteArrayAt(c_u32 index) const {
+NBTTagByteArray* NBTTagList::getByteArrayAt(c_u32 index) {
     if (tagType == TAG_BYTE_ARRAY) {
         if (index < tagList.size()) {
-            const NBTBase nbtBase = tagList.at(index);
-            return NBTBase::toType<NBTTagByteArray>(nbtBase);
+            return tagList[index].makeUnique().toType<NBTTagByteArray>();
         }
     }
     return nullptr;
@@ -816,44 +1044,40 @@ std::string NBTTagList::getStringTagAt(c_u32 index) const {
 }
 
 
-NBTTagList* NBTTagList::getListTagAt(c_u32 index) const {
+NBTTagList* NBTTagList::getListTagAt(c_u32 index) {
     if (tagType == TAG_LIST) {
         if (index < tagList.size()) {
-            const NBTBase nbtBase = tagList.at(index);
-            return NBTBase::toType<NBTTagList>(nbtBase);
+            return tagList[index].makeUnique().toType<NBTTagList>();
         }
     }
     return nullptr;
 }
 
 
-MU NBTTagCompound* NBTTagList::getCompoundTagAt(c_u32 index) const {
+MU NBTTagCompound* NBTTagList::getCompoundTagAt(c_u32 index) {
     if (tagType == TAG_COMPOUND) {
         if (index < tagList.size()) {
-            const NBTBase nbtBase = tagList.at(index);
-            return NBTBase::toType<NBTTagCompound>(nbtBase);
+            return tagList[index].makeUnique().toType<NBTTagCompound>();
         }
     }
     return nullptr;
 }
 
 
-MU NBTTagIntArray* NBTTagList::getIntArrayAt(c_u32 index) const {
+MU NBTTagIntArray* NBTTagList::getIntArrayAt(c_u32 index) {
     if (tagType == TAG_INT_ARRAY) {
         if (index < tagList.size()) {
-            const NBTBase nbtBase = tagList.at(index);
-            return NBTBase::toType<NBTTagIntArray>(nbtBase);
+            return tagList[index].makeUnique().toType<NBTTagIntArray>();
         }
     }
     return nullptr;
 }
 
 
-NBTTagLongArray* NBTTagList::getLongArrayAt(c_u32 index) const {
+NBTTagLongArray* NBTTagList::getLongArrayAt(c_u32 index) {
     if (tagType == TAG_LONG_ARRAY) {
         if (index < tagList.size()) {
-            const NBTBase nbtBase = tagList.at(index);
-            return NBTBase::toType<NBTTagLongArray>(nbtBase);
+            return tagList[index].makeUnique().toType<NBTTagLongArray>();
         }
     }
     return nullptr;
@@ -900,26 +1124,65 @@ NBTTagCompound* NBTUtil::createPosTag(BlockPos pos) {
 */
 
 
-void NBT::writeTag(const NBTBase* tag, DataManager& output) {
-    output.writeInt8(tag->getId());
+template<class Writer>
+static void writeTagWith(const NBTBase* tag, Writer& writer) {
+    writer.writeInt8(tag->getId());
 
     if (tag->getId() != NBT_NONE) {
-        output.writeUTF("");
-        tag->write(output);
+        writer.writeUTF("");
+        writeWith(*tag, writer);
     }
 }
 
 
+void NBT::writeTag(const NBTBase* tag, DataManager& output) {
+    DataWriter<Endian::Big> writer(output);
+    writeTagWith(tag, writer);
+}
+
+
+void NBT::writeTag(const NBTBase* tag, OutputBuffer& output) {
+    BufferWriter<Endian::Big> writer(output);
+    writeTagWith(tag, writer);
+}
+
+
+void NBT::writeTagUnchecked(const NBTBase* tag, OutputBuffer& output) {
+    assert(serializedSize(tag) <= output.capacity() - output.getPosition());
+    UncheckedBufferWriter<Endian::Big> writer(output);
+    writeTagWith(tag, writer);
+}
+
+
+u64 NBT::serializedSize(const NBTBase* tag) {
+    // the id, then an empty name
+    return tag->getId() == NBT_NONE ? 1 : 3 + payloadSize(*tag);
+}
+
+
 NBTBase* NBT::readTag(DataManager& input) {
+    DataReader<Endian::Big> reader(input);
     NBTBase* returnValue = nullptr;
-    if (int id = input.readInt8(); id != 0) {
-        const std::string key = input.readUTF();
+    if (int id = reader.readInt8(); id != 0) {
+        const std::string key = reader.readUTF();
         returnValue = readNBT(static_cast<NBTType>(id), key, input);
     }
     return returnValue;
 }
 
 
+NBTBase* NBT::readTag(DataManager& input, NBTArena& theArena, c_bool isBorrowingBytes) {
+    DataReader<Endian::Big> reader(input);
+    NBTBase* returnValue = nullptr;
+    if (int id = reader.readInt8(); id != 0) {
+        input.incrementPointer(reader.readInt16());
+        returnValue = theArena.create<NBTBase>(makeByType(static_cast<NBTType>(id), &theArena));
+        returnValue->read(input, &theArena, isBorrowingBytes);
+    }
+    return returnValue;
+}
+
+
 NBTBase* NBT::readNBT(const NBTType tagID, MU const std::string& key, DataManager& input) {
     NBTBase* pNbtBase = createNewByType(tagID);
     pNbtBase->read(input);
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstring>
+#include <memory_resource>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <ranges>
@@ -11,6 +13,9 @@
 
 
 class DataManager;
+class NBTArena;
+class NBTVisitor;
+class OutputBuffer;
 
 enum NBTType : u8 {
     NBT_NONE = 0,
@@ -30,8 +35,18 @@ enum NBTType : u8 {
 };
 
 
+/**
+ * What every tag payload starts with: how many tags hold it besides the first.
+ * Only heap payloads are ever shared, see NBTBase::share.
+ */
+class NBTShared {
+public:
+    u32 shareCount = 0;
+};
+
+
 template<class classType>
-class NBTTagTypeArray {
+class NBTTagTypeArray : public NBTShared {
 public:
     classType* array = nullptr;
     int size = 0;
@@ -63,27 +78,71 @@ concept NBT_TAG_TYPE = std::is_same_v<T, NBTTagByteArray> ||
 
 class NBTBase {
 public:
-    void* data;
+    union {
+        void* data;
+        /// primitives are stored inline instead of behind data, see getValue / setValue.
+        u64 value;
+    };
     NBTType type;
+    /// its memory belongs to an NBTArena, so NbtFree leaves it alone.
+    bool isArenaOwned = false;
 
     NBTBase(void* dataIn, const NBTType typeIn) : data(dataIn), type(typeIn) {}
 
     NBTBase() : NBTBase(nullptr, NBT_NONE) {}
 
-    NBTBase(void* dataIn, c_int dataSizeIn, const NBTType typeIn) : NBTBase(dataIn, typeIn) {
-        std::memcpy(data, dataIn, dataSizeIn);
+    /// a primitive, the dataSizeIn bytes at dataIn are copied inline.
+    NBTBase(const void* dataIn, c_int dataSizeIn, const NBTType typeIn) : value(0), type(typeIn) {
+        std::memcpy(&value, dataIn, dataSizeIn);
     }
 
     void write(DataManager& output) const;
+    void write(OutputBuffer& output) const;
 
-    void read(DataManager& input);
+    /**
+     * With an arena, everything read is allocated from it.
+     * @param isBorrowingBytes only with an arena, byte arrays then point into input
+     * instead of being copied, so input must outlive the tree.
+     */
+    void read(DataManager& input, NBTArena* theArena = nullptr, bool isBorrowingBytes = false);
 
     ND std::string toString() const;
 
-    ND NBTBase copy() const;
-
+    /// a deep copy, on the heap or in theArena.
+    ND NBTBase copy(NBTArena* theArena = nullptr) const;
+
+    /**
+     * Another tag for the same payload, without copying anything: both are read-only
+     * until makeUnique(), and each is NbtFree'd as usual, the last one freeing it.\n
+     * Only heap tags are shared, arena tags and primitives are copied onto the heap.
+     */
+    ND NBTBase share() const;
+    /// true while share() has another tag holding its payload.
+    ND bool isShared() const;
+    /**
+     * Copy-on-write: if its payload is shared, it is given one of its own first.
+     * Children are shared into it rather than copied, so only this level is;
+     * the non-const getters of compounds and lists call it on each tag on the way down.
+     * @return this tag.
+     */
+    NBTBase& makeUnique();
+
+    /// frees the payload, or if it is shared, lets go of it.
     void NbtFree() const;
 
+    template<class T>
+    ND T getValue() const {
+        T result;
+        std::memcpy(&result, &value, sizeof(T));
+        return result;
+    }
+
+    template<class T>
+    void setValue(const T theValue) {
+        value = 0;
+        std::memcpy(&value, &theValue, sizeof(T));
+    }
+
     static bool equals(NBTBase check);
 
     ND NBTType getId() const { return type; }
@@ -92,17 +151,17 @@ public:
     classType toPrim() {
         switch (type) {
             case NBT_INT8:
-                return (classType) *(u8*) data;
+                return (classType) getValue<u8>();
             case NBT_INT16:
-                return (classType) *(i16*) data;
+                return (classType) getValue<i16>();
             case NBT_INT32:
-                return (classType) *(i32*) data;
+                return (classType) getValue<i32>();
             case NBT_INT64:
-                return (classType) *(i64*) data;
+                return (classType) getValue<i64>();
             case NBT_FLOAT:
-                return (classType) *(float*) data;
+                return (classType) getValue<float>();
             case NBT_DOUBLE:
-                return (classType) *(double*) data;
+                return (classType) getValue<double>();
             default:
                 return 0;
         }
@@ -126,16 +185,55 @@ public:
 
 
 
-class NBTTagString {
+/**
+ * Owns the memory of a whole NBT tree: its nodes, strings, arrays and containers
+ * are bumped out of a few large blocks, so reading a tree is a handful of
+ * allocations and freeing it is dropping the blocks; NbtFree is never needed.\n
+ * Heap tags set into one of its compounds are adopted, and freed along with it.
+ * copy() takes a tag back out onto the heap.
+ */
+class NBTArena {
+    std::pmr::monotonic_buffer_resource myResource;
+    std::vector<NBTBase> myAdopted;
+
+public:
+    static constexpr size_t BLOCK_SIZE = 16 * 1024;
+
+    NBTArena() : myResource(BLOCK_SIZE) {}
+    ~NBTArena() { release(); }
+
+    NBTArena(const NBTArena&) = delete;
+    NBTArena& operator=(const NBTArena&) = delete;
+
+    ND std::pmr::memory_resource* resource() { return &myResource; }
+
+    ND void* allocate(c_u64 theSize, c_u64 theAlign = alignof(std::max_align_t)) {
+        return myResource.allocate(theSize, theAlign);
+    }
+
+    template<class T, class... Args>
+    ND T* create(Args&&... theArgs) {
+        return new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(theArgs)...);
+    }
+
+    /// theTag is freed by the arena from now on, and is marked as owned by it.
+    void adopt(NBTBase& theTag);
+
+    /// frees everything allocated from it at once, destructors are not run.
+    void release();
+};
+
+
+class NBTTagString : public NBTShared {
 public:
     char* data;
     i64 size;
     NBTTagString() : data(nullptr), size(0) {}
 
-    explicit NBTTagString(const std::string& dataIn) {
+    explicit NBTTagString(const std::string_view dataIn, NBTArena* theArena = nullptr) {
         size = static_cast<int>(dataIn.size());
-        data = static_cast<char*>(malloc(size));
-        std::memcpy(data, dataIn.c_str(), size);
+        data = static_cast<char*>(theArena != nullptr ? theArena->allocate(size, 1) : malloc(size));
+        std::memcpy(data, dataIn.data(), size);
     }
 
     ND bool hasNoTags() const { return size != 0; }
@@ -154,17 +252,130 @@ public:
 };
 
 
-class NBTTagList;
+/// FNV-1a, so key literals are hashed at compile time.
+constexpr u32 nbtKeyHash(const std::string_view theName) {
+    u32 hash = 0x811C9DC5;
+    for (const char chara : theName) {
+        hash = (hash ^ static_cast<u8>(chara)) * 0x01000193;
+    }
+    return hash;
+}
 
-class NBTTagCompound {
-    typedef const std::string& STR;
 
+/// An interned key, there is only ever one per name, see NBTKeys.
+struct NBTKeyName {
+    std::string_view name;
+    u32 hash;
+};
+
+
+/// the keys chunks, entities and items are made of, they are interned before anything is read.
+inline constexpr NBTKeyName NBT_COMMON_KEYS[] = {
+#define NBT_KEY(name) {name, nbtKeyHash(name)}
+    NBT_KEY("id"), NBT_KEY("x"), NBT_KEY("y"), NBT_KEY("z"), NBT_KEY("i"), NBT_KEY("t"), NBT_KEY("p"),
+    NBT_KEY("Entities"), NBT_KEY("TileEntities"), NBT_KEY("TileTicks"), NBT_KEY("SpawnAreas"),
+    NBT_KEY("Items"), NBT_KEY("Count"), NBT_KEY("Damage"), NBT_KEY("Slot"), NBT_KEY("tag"),
+    NBT_KEY("Pos"), NBT_KEY("Motion"), NBT_KEY("Rotation"), NBT_KEY("FallDistance"), NBT_KEY("Fire"),
+    NBT_KEY("Air"), NBT_KEY("OnGround"), NBT_KEY("Dimension"), NBT_KEY("Invulnerable"),
+    NBT_KEY("PortalCooldown"), NBT_KEY("UUIDMost"), NBT_KEY("UUIDLeast"), NBT_KEY("Health"),
+    NBT_KEY("HurtTime"), NBT_KEY("DeathTime"), NBT_KEY("Equipment"), NBT_KEY("CustomName"), NBT_KEY("Age"),
+    NBT_KEY("Name"), NBT_KEY("LootTable"), NBT_KEY("LootTableSeed"), NBT_KEY("Data"), NBT_KEY("Level"),
+    NBT_KEY("xPos"), NBT_KEY("zPos"), NBT_KEY("LastUpdate"), NBT_KEY("Blocks"), NBT_KEY("SkyLight"),
+    NBT_KEY("BlockLight"), NBT_KEY("HeightMap"), NBT_KEY("Biomes"), NBT_KEY("TerrainPopulated"),
+#undef NBT_KEY
+};
+
+
+/// the interner, every compound key is one of its records.
+class NBTKeys {
+public:
+    /// the record for theName, made the first time it is seen and never freed.
+    static const NBTKeyName* intern(std::string_view theName, u32 theHash);
+    static const NBTKeyName* intern(const std::string_view theName) { return intern(theName, nbtKeyHash(theName)); }
+
+    static consteval const NBTKeyName* findCommon(const std::string_view theName) {
+        for (const NBTKeyName& key : NBT_COMMON_KEYS) {
+            if (key.name == theName) { return &key; }
+        }
+        return nullptr;
+    }
+};
+
+
+/**
+ * What compounds are searched with.
+
+ * A string literal is hashed at compile time, and if it is one of
+ * NBT_COMMON_KEYS it is already interned, so finding it compares pointers only.
+ */
+class NBTKey {
 public:
-    std::unordered_map<std::string, NBTBase> tagMap;
+    std::string_view name;
+    u32 hash;
+    /// set if its record is known.
+    const NBTKeyName* interned = nullptr;
+
+    template<size_t N>
+    consteval NBTKey(const char (&theName)[N]) // NOLINT(*-explicit-constructor)
+        : name(theName, N - 1), hash(nbtKeyHash(name)), interned(NBTKeys::findCommon(name)) {}
+    NBTKey(const std::string_view theName) : name(theName), hash(nbtKeyHash(theName)) {} // NOLINT(*-explicit-constructor)
+    NBTKey(const std::string& theName) : NBTKey(std::string_view(theName)) {} // NOLINT(*-explicit-constructor)
+    NBTKey(const NBTKeyName* theKey) : name(theKey->name), hash(theKey->hash), interned(theKey) {} // NOLINT(*-explicit-constructor)
+
+    ND bool matches(const NBTKeyName* theKey) const {
+        if (interned != nullptr) {
+            return interned == theKey;
+        }
+        return theKey->hash == hash && theKey->name == name;
+    }
+};
 
-    static void writeEntry(STR name, NBTBase data, DataManager& output);
+
+class NBTTagList;
+
+class NBTTagCompound : public NBTShared {
+    typedef const NBTKey& STR;
+
+    /// sets or replaces key, freeing what it replaces.
+    void put(STR key, NBTBase value);
+    /// find without making the tag unique, for reading it or replacing it outright.
+    ND NBTBase* findEntry(STR key) const;
+
+public:
+    /// a key and its tag, in the order they were set.
+    struct Entry {
+        const NBTKeyName* key;
+        NBTBase tag;
+    };
+
+    /**
+     * Compounds are small and their keys repeat, so they are a flat list over
+     * interned keys, searched front to back, instead of a hash map of strings.
+     */
+    using EntryList = std::pmr::vector<Entry>;
+
+    EntryList entries;
+    /// set if it lives in an arena, the tags made for it are then made there too.
+    NBTArena* arena = nullptr;
+
+    NBTTagCompound() = default;
+    explicit NBTTagCompound(NBTArena* theArena) : entries(theArena->resource()), arena(theArena) {}
+
+    static void writeEntry(std::string_view name, NBTBase data, DataManager& output);
+    static void writeEntry(std::string_view name, NBTBase data, OutputBuffer& output);
     int getSize() const;
 
+    /**
+     * The tag, which the caller may change: if it is shared (NBTBase::share) it is made unique first,
+     * as are the tags the other non-const getters hand out, so changes never reach the other holders.\n
+     * This compound has to be unique itself, which it is if it was reached through them.
+     */
+    ND NBTBase* find(STR key);
+    /// the tag as it is, shared or not, only to be read.
+    ND const NBTBase* find(STR key) const;
+    /// like find, but only if the tag is of type; TAG_PRIMITIVE matches any number.
+    ND NBTBase* findOfType(STR key, int type);
+
     // set tags
     void setTag(STR key, NBTBase value);
     void setByte(STR key, u8 value);
@@ -173,7 +384,7 @@ public:
     void setLong(STR key, i64 value);
     void setFloat(STR key, float value);
     void setDouble(STR key, double value);
-    void setString(STR key, STR value);
+    void setString(STR key, std::string_view value);
     void setByteArray(STR key, c_u8* value, int size);
     void setIntArray(STR key, c_int* value, int size);
     void setLongArray(STR key, const i64* value, int size);
@@ -183,6 +394,12 @@ public:
 
     bool hasUniqueId(STR key);
     NBTBase getTag(STR key);
+    /**
+     * Removes key without freeing its tag, and hands the tag over as it is, without copying:
+     * a heap tag is the caller's to free, an arena tag still goes with its arena.
+     * @return the tag, or NBT_NONE if there is none.
+     */
+    NBTBase extractTag(STR key);
     NBTType getTagId(STR key);
 
     bool hasKey(STR key) const;
@@ -191,8 +408,8 @@ public:
     std::vector<std::string> getKeySet();
     template<typename classType>
     classType getPrimitive(STR key) {
-        if (hasKey(key, TAG_PRIMITIVE)) {
-            return tagMap.at(key).toPrim<classType>();
+        if (NBTBase* tag = findOfType(key, TAG_PRIMITIVE)) {
+            return tag->toPrim<classType>();
         }
         return static_cast<classType>(0);
     }
@@ -213,12 +430,13 @@ public:
 };
 
 
-class NBTTagList {
+class NBTTagList : public NBTShared {
 public:
-    std::vector<NBTBase> tagList;
+    std::pmr::vector<NBTBase> tagList;
     NBTType tagType;
 
     NBTTagList() : tagType(NBT_NONE) {}
+    explicit NBTTagList(NBTArena* theArena) : tagList(theArena->resource()), tagType(NBT_NONE) {}
 
     MU void appendTag(NBTBase nbt);
     void set(const uint32_t index, const NBTBase nbt);
@@ -239,12 +457,13 @@ public:
         return static_cast<classType>(0);
     }
 
-    MU ND NBTTagByteArray* getByteArrayAt(const uint32_t index) const;
+    /// these make the element unique before handing it out, see NBTTagCompound::find.
+    MU ND NBTTagByteArray* getByteArrayAt(const uint32_t index);
     MU ND std::string getStringTagAt(const uint32_t index) const;
-    MU ND NBTTagList* getListTagAt(const uint32_t index) const;
-    MU ND NBTTagCompound* getCompoundTagAt(const uint32_t index) const;
-    MU ND NBTTagIntArray* getIntArrayAt(const uint32_t index) const;
-    MU ND NBTTagLongArray* getLongArrayAt(const uint32_t index) const;
+    MU ND NBTTagList* getListTagAt(const uint32_t index);
+    MU ND NBTTagCompound* getCompoundTagAt(const uint32_t index);
+    MU ND NBTTagIntArray* getIntArrayAt(const uint32_t index);
+    MU ND NBTTagLongArray* getLongArrayAt(const uint32_t index);
     MU ND NBTBase get(const uint32_t index) const;
     MU ND int tagCount() const;
     MU ND NBTType getTagType() const;
@@ -264,63 +483,62 @@ public:
 class NBT {
 public:
     MU static bool isCompoundTag(const NBTType type) { return type == TAG_COMPOUND; }
+    /// NBT is always big endian, whatever the DataManager is set to.
     static void writeTag(const NBTBase* tag, DataManager& output);
+    /// same as above, growing output as needed.
+    static void writeTag(const NBTBase* tag, OutputBuffer& output);
+    /**
+     * Same as above without any bounds checks, for when output already has
+     * serializedSize(tag) bytes of room after its position.\n
+     * Sizing costs a walk of the tree, so this pays off where the size is needed anyway:
+     * to allocate a fresh buffer exactly once.
+     */
+    static void writeTagUnchecked(const NBTBase* tag, OutputBuffer& output);
+    /// the exact number of bytes writeTag writes for tag, found without writing it.
+    static u64 serializedSize(const NBTBase* tag);
     static NBTBase* readTag(DataManager& input);
+    /// the tag and everything in it is made in theArena, freeing the arena frees it.
+    /// With isBorrowingBytes its byte arrays point into input instead, see NBTBase::read.
+    static NBTBase* readTag(DataManager& input, NBTArena& theArena, bool isBorrowingBytes = false);
     static NBTBase* readNBT(NBTType tagID, const std::string& key, DataManager& input);
+
+    /**
+     * Walks the tag at input's cursor, handing it to theVisitor piece by piece instead of building it.
+     * @return SUCCESS, or INVALID_SAVE if it is cut short or malformed.
+     */
+    static int visit(DataManager& input, NBTVisitor& theVisitor);
+    /// moves input's cursor past a payload of type, using the length prefixes to jump over it.
+    static int skip(NBTType type, DataManager& input);
 };
 
 
 MU static NBTBase createNBT_INT8(c_i8 dataIn) {
-    NBTBase nbtBase;
-    nbtBase.data = malloc(sizeof(dataIn));
-    std::memcpy(nbtBase.data, &dataIn, sizeof(dataIn));
-    nbtBase.type = NBT_INT8;
-    return nbtBase;
+    return {&dataIn, sizeof(dataIn), NBT_INT8};
 }
 
 
 MU static NBTBase createNBT_INT16(c_i16 dataIn) {
-    NBTBase nbtBase;
-    nbtBase.data = malloc(sizeof(dataIn));
-    std::memcpy(nbtBase.data, &dataIn, sizeof(dataIn));
-    nbtBase.type = NBT_INT16;
-    return nbtBase;
+    return {&dataIn, sizeof(dataIn), NBT_INT16};
 }
 
 
 MU static NBTBase createNBT_INT32(c_i32 dataIn) {
-    NBTBase nbtBase;
-    nbtBase.data = malloc(sizeof(dataIn));
-    std::memcpy(nbtBase.data, &dataIn, sizeof(dataIn));
-    nbtBase.type = NBT_INT32;
-    return nbtBase;
+    return {&dataIn, sizeof(dataIn), NBT_INT32};
 }
 
 
 MU static NBTBase createNBT_INT64(const i64 dataIn) {
-    NBTBase nbtBase;
-    nbtBase.data = malloc(sizeof(dataIn));
-    std::memcpy(nbtBase.data, &dataIn, sizeof(dataIn));
-    nbtBase.type = NBT_INT64;
-    return nbtBase;
+    return {&dataIn, sizeof(dataIn), NBT_INT64};
 }
 
 
 MU static NBTBase createNBT_FLOAT(const float dataIn) {
-    NBTBase nbtBase;
-    nbtBase.data = malloc(sizeof(dataIn));
-    std::memcpy(nbtBase.data, &dataIn, sizeof(dataIn));
-    nbtBase.type = NBT_FLOAT;
-    return nbtBase;
+    return {&dataIn, sizeof(dataIn), NBT_FLOAT};
 }
 
 
 MU static NBTBase createNBT_DOUBLE(const double dataIn) {
-    NBTBase nbtBase;
-    nbtBase.data = malloc(sizeof(dataIn));
-    std::memcpy(nbtBase.data, &dataIn, sizeof(dataIn));
-    nbtBase.type = NBT_DOUBLE;
-    return nbtBase;
+    return {&dataIn, sizeof(dataIn), NBT_DOUBLE};
 }
 
 
@@ -356,30 +574,63 @@ MU static NBTBase convertType(NBTBase baseData, NBTType toType) {
 }
 
 
-inline NBTBase* createNewByType(NBTType type) {
+/// an empty tag of type, made in theArena if there is one.
+inline NBTBase makeByType(const NBTType type, NBTArena* theArena = nullptr) {
+    NBTBase tag(nullptr, type);
+    if (theArena != nullptr) {
+        tag.isArenaOwned = true;
+        switch (type) {
+            case TAG_BYTE_ARRAY:
+                tag.data = theArena->create<NBTTagByteArray>();
+                break;
+            case TAG_STRING:
+                tag.data = theArena->create<NBTTagString>();
+                break;
+            case TAG_LIST:
+                tag.data = theArena->create<NBTTagList>(theArena);
+                break;
+            case TAG_COMPOUND:
+                tag.data = theArena->create<NBTTagCompound>(theArena);
+                break;
+            case TAG_INT_ARRAY:
+                tag.data = theArena->create<NBTTagIntArray>();
+                break;
+            case TAG_LONG_ARRAY:
+                tag.data = theArena->create<NBTTagLongArray>();
+                break;
+            default:
+                break;
+        }
+        return tag;
+    }
     switch (type) {
-        case NBT_NONE:
-        case NBT_INT8:
-        case NBT_INT16:
-        case NBT_INT32:
-        case NBT_INT64:
-        case NBT_FLOAT:
-        case NBT_DOUBLE:
-        default:
-            return new NBTBase(nullptr, type);
         case TAG_BYTE_ARRAY:
-            return new NBTBase(new NBTTagByteArray(), type);
+            tag.data = new NBTTagByteArray();
+            break;
         case TAG_STRING:
-            return new NBTBase(new NBTTagString(), type);
+            tag.data = new NBTTagString();
+            break;
         case TAG_LIST:
-            return new NBTBase(new NBTTagList(), type);
+            tag.data = new NBTTagList();
+            break;
         case TAG_COMPOUND:
-            return new NBTBase(new NBTTagCompound(), type);
+            tag.data = new NBTTagCompound();
+            break;
         case TAG_INT_ARRAY:
-            return new NBTBase(new NBTTagIntArray(), type);
+            tag.data = new NBTTagIntArray();
+            break;
         case TAG_LONG_ARRAY:
-            return new NBTBase(new NBTTagLongArray(), type);
+            tag.data = new NBTTagLongArray();
+            break;
+        default:
+            break;
     }
+    return tag;
+}
+
+
+inline NBTBase* createNewByType(const NBTType type) {
+    return new NBTBase(makeByType(type));
 }
 
 
@@ -387,19 +638,17 @@ MU static void compareNBT(const NBTBase* first, const NBTBase* second) {
     auto* firstNBT = NBTBase::toType<NBTTagCompound>(first)->getCompoundTag("Data");
     auto* secondNBT = NBTBase::toType<NBTTagCompound>(second)->getCompoundTag("Data");
 
-    // Iterate over the keys of firstNBT->tagMap
-    for (const auto& entry : firstNBT->tagMap) {
-        const auto& key = entry.first;
+    // Iterate over the keys of firstNBT
+    for (const auto& [key, tag] : firstNBT->entries) {
         if (!secondNBT->hasKey(key)) {
-            printf("second does not contain tag '%s'\n", key.c_str());
+            printf("second does not contain tag '%.*s'\n", static_cast<int>(key->name.size()), key->name.data());
         }
     }
 
-    // Iterate over the keys of secondNBT->tagMap
-    for (const auto& entry : secondNBT->tagMap) {
-        const auto& key = entry.first;
+    // Iterate over the keys of secondNBT
+    for (const auto& [key, tag] : secondNBT->entries) {
         if (!firstNBT->hasKey(key)) {
-            printf("first does not contain tag '%s'\n", key.c_str());
+            printf("first does not contain tag '%.*s'\n", static_cast<int>(key->name.size()), key->name.data());
         }
     }
 }
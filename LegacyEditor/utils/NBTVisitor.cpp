@@ -0,0 +1,238 @@
+#include "NBTVisitor.hpp"
+
+#include "LegacyEditor/utils/error_status.hpp"
+
+
+/// the nesting limit of the format, deeper input is treated as malformed.
+static constexpr u32 MAX_DEPTH = 512;
+
+
+static u32 primitiveSize(const NBTType type) {
+    switch (type) {
+        case NBT_INT8:
+            return 1;
+        case NBT_INT16:
+            return 2;
+        case NBT_INT32:
+        case NBT_FLOAT:
+            return 4;
+        case NBT_INT64:
+        case NBT_DOUBLE:
+            return 8;
+        default:
+            return 0;
+    }
+}
+
+
+static bool fits(const DataManager& input, c_u64 theAmount) {
+    return static_cast<u64>(input.data + input.size - input.ptr) >= theAmount;
+}
+
+
+/**
+ * Finds the extent of a tag that is not a compound or list.
+ * @return false if type is not one, or it does not fit in input.
+ */
+static bool readLeaf(const DataManager& input, const NBTType type, NBTValueView& viewOut) {
+    viewOut.type = type;
+    viewOut.ptr = input.ptr;
+    viewOut.count = 1;
+    switch (type) {
+        case NBT_INT8:
+        case NBT_INT16:
+        case NBT_INT32:
+        case NBT_INT64:
+        case NBT_FLOAT:
+        case NBT_DOUBLE:
+            viewOut.size = primitiveSize(type);
+            break;
+        case TAG_STRING:
+            if (!fits(input, 2)) { return false; }
+            viewOut.count = endian::load<Endian::Big, u16>(input.ptr);
+            viewOut.size = 2 + viewOut.count;
+            break;
+        case TAG_BYTE_ARRAY:
+        case TAG_INT_ARRAY:
+        case TAG_LONG_ARRAY: {
+            if (!fits(input, 4)) { return false; }
+            viewOut.count = endian::load<Endian::Big, u32>(input.ptr);
+            c_u64 width = type == TAG_BYTE_ARRAY ? 1 : type == TAG_INT_ARRAY ? 4 : 8;
+            c_u64 size = 4 + viewOut.count * width;
+            if (!fits(input, size)) { return false; }
+            viewOut.size = static_cast<u32>(size);
+            break;
+        }
+        default:
+            return false;
+    }
+    return fits(input, viewOut.size);
+}
+
+
+static bool readName(DataManager& input, std::string_view& nameOut) {
+    if (!fits(input, 2)) { return false; }
+    c_u16 length = endian::load<Endian::Big, u16>(input.ptr);
+    if (!fits(input, 2 + length)) { return false; }
+    nameOut = std::string_view(reinterpret_cast<const char*>(input.ptr + 2), length);
+    input.incrementPointer(2 + length);
+    return true;
+}
+
+
+static int skipPayload(const NBTType type, DataManager& input, c_u32 depth) {
+    if (depth > MAX_DEPTH) {
+        return INVALID_SAVE;
+    }
+    switch (type) {
+        case TAG_LIST: {
+            if (!fits(input, 5)) { return INVALID_SAVE; }
+            c_auto elementType = static_cast<NBTType>(input.ptr[0]);
+            c_u32 count = endian::load<Endian::Big, u32>(input.ptr + 1);
+            input.incrementPointer(5);
+            // lists of primitives are skipped in one jump
+            if (c_u32 width = primitiveSize(elementType); width != 0) {
+                if (!fits(input, static_cast<u64>(count) * width)) { return INVALID_SAVE; }
+                input.incrementPointer(count * width);
+                return SUCCESS;
+            }
+            for (u32 index = 0; index < count; index++) {
+                if (c_int status = skipPayload(elementType, input, depth + 1); status != SUCCESS) {
+                    return status;
+                }
+            }
+            return SUCCESS;
+        }
+        case TAG_COMPOUND: {
+            std::string_view name;
+            while (true) {
+                if (!fits(input, 1)) { return INVALID_SAVE; }
+                c_auto tagType = static_cast<NBTType>(input.ptr[0]);
+                input.incrementPointer1();
+                if (tagType == NBT_NONE) {
+                    return SUCCESS;
+                }
+                if (!readName(input, name)) { return INVALID_SAVE; }
+                if (c_int status = skipPayload(tagType, input, depth + 1); status != SUCCESS) {
+                    return status;
+                }
+            }
+        }
+        default: {
+            NBTValueView view;
+            if (!readLeaf(input, type, view)) { return INVALID_SAVE; }
+            input.incrementPointer(view.size);
+            return SUCCESS;
+        }
+    }
+}
+
+
+/// walks one NBT::visit call, noting when the visitor asked to stop.
+class NBTWalker {
+    DataManager& myInput;
+    NBTVisitor& myVisitor;
+
+public:
+    bool isStopped = false;
+
+    NBTWalker(DataManager& theInput, NBTVisitor& theVisitor) : myInput(theInput), myVisitor(theVisitor) {}
+
+    /// @return true if the walk goes on after seeing result.
+    bool goesOn(const NBTVisit result) {
+        isStopped = result == NBTVisit::STOP;
+        return !isStopped;
+    }
+
+    int walk(const NBTType type, const std::string_view name, c_u32 depth) {
+        if (depth > MAX_DEPTH) {
+            return INVALID_SAVE;
+        }
+        switch (type) {
+            case TAG_COMPOUND: {
+                c_auto result = myVisitor.onCompoundBegin(name);
+                if (!goesOn(result)) { return SUCCESS; }
+                if (result == NBTVisit::SKIP) { return skipPayload(type, myInput, depth); }
+
+                std::string_view key;
+                while (true) {
+                    if (!fits(myInput, 1)) { return INVALID_SAVE; }
+                    c_auto tagType = static_cast<NBTType>(myInput.ptr[0]);
+                    myInput.incrementPointer1();
+                    if (tagType == NBT_NONE) {
+                        break;
+                    }
+                    if (!readName(myInput, key)) { return INVALID_SAVE; }
+                    if (c_int status = walk(tagType, key, depth + 1); status != SUCCESS || isStopped) {
+                        return status;
+                    }
+                }
+                goesOn(myVisitor.onCompoundEnd());
+                return SUCCESS;
+            }
+            case TAG_LIST: {
+                if (!fits(myInput, 5)) { return INVALID_SAVE; }
+                auto elementType = static_cast<NBTType>(myInput.ptr[0]);
+                c_u32 count = endian::load<Endian::Big, u32>(myInput.ptr + 1);
+                // same as NBTBase::read, empty lists carry no type
+                if (count == 0) {
+                    elementType = NBT_NONE;
+                } else if (elementType == NBT_NONE) {
+                    return INVALID_SAVE;
+                }
+
+                c_auto result = myVisitor.onListBegin(name, elementType, count);
+                if (!goesOn(result)) { return SUCCESS; }
+                if (result == NBTVisit::SKIP) { return skipPayload(type, myInput, depth); }
+
+                myInput.incrementPointer(5);
+                for (u32 index = 0; index < count; index++) {
+                    if (c_int status = walk(elementType, {}, depth + 1); status != SUCCESS || isStopped) {
+                        return status;
+                    }
+                }
+                goesOn(myVisitor.onListEnd());
+                return SUCCESS;
+            }
+            default: {
+                NBTValueView view;
+                if (!readLeaf(myInput, type, view)) { return INVALID_SAVE; }
+                myInput.incrementPointer(view.size);
+                goesOn(myVisitor.onTag(name, type, view));
+                return SUCCESS;
+            }
+        }
+    }
+};
+
+
+NBTBase NBTValueView::toTag(NBTArena* theArena) const {
+    NBTBase tag = makeByType(type, theArena);
+    DataManager managerIn(const_cast<u8*>(ptr), size);
+    tag.read(managerIn, theArena);
+    return tag;
+}
+
+
+int NBT::visit(DataManager& input, NBTVisitor& theVisitor) {
+    if (!fits(input, 1)) {
+        return INVALID_SAVE;
+    }
+    c_auto type = static_cast<NBTType>(input.ptr[0]);
+    input.incrementPointer1();
+    if (type == NBT_NONE) {
+        return SUCCESS;
+    }
+
+    std::string_view name;
+    if (!readName(input, name)) {
+        return INVALID_SAVE;
+    }
+    NBTWalker walker(input, theVisitor);
+    return walker.walk(type, name, 0);
+}
+
+
+int NBT::skip(const NBTType type, DataManager& input) {
+    return skipPayload(type, input, 0);
+}
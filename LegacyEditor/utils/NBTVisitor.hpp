@@ -0,0 +1,96 @@
+#pragma once
+
+#include <bit>
+#include <string_view>
+
+#include "LegacyEditor/utils/NBT.hpp"
+#include "LegacyEditor/utils/dataReader.hpp"
+
+
+/// what an NBTVisitor wants NBT::visit to do next.
+enum class NBTVisit : u8 {
+    CONTINUE,
+    /// from onCompoundBegin / onListBegin: jump past its contents, its end is not reported.
+    SKIP,
+    /// stop reading, NBT::visit returns SUCCESS right away.
+    STOP
+};
+
+
+/**
+ * A tag's payload where it lies in the input; nothing is decoded or copied until asked.\n
+ * It points into the input, so it is only valid while the input is.
+ */
+class NBTValueView {
+public:
+    NBTType type = NBT_NONE;
+    /// the payload as NBTBase::read reads it, length prefix included.
+    c_u8* ptr = nullptr;
+    /// the payload's size in bytes.
+    u32 size = 0;
+    /// the length of strings and arrays, 1 for primitives.
+    u32 count = 0;
+
+    /// the same conversions as NBTBase::toPrim.
+    template<class classType>
+    ND classType toPrim() const {
+        switch (type) {
+            case NBT_INT8:
+                return (classType) ptr[0];
+            case NBT_INT16:
+                return (classType) static_cast<i16>(endian::load<Endian::Big, u16>(ptr));
+            case NBT_INT32:
+                return (classType) static_cast<i32>(endian::load<Endian::Big, u32>(ptr));
+            case NBT_INT64:
+                return (classType) static_cast<i64>(endian::load<Endian::Big, u64>(ptr));
+            case NBT_FLOAT:
+                return (classType) std::bit_cast<float>(endian::load<Endian::Big, u32>(ptr));
+            case NBT_DOUBLE:
+                return (classType) std::bit_cast<double>(endian::load<Endian::Big, u64>(ptr));
+            default:
+                return 0;
+        }
+    }
+
+    ND std::string_view getString() const {
+        return type == TAG_STRING ? std::string_view(reinterpret_cast<const char*>(ptr + 2), count) : "";
+    }
+
+    /// the elements of TAG_BYTE_ARRAY / TAG_INT_ARRAY / TAG_LONG_ARRAY, index must be below count.
+    ND u8 getByteAt(c_u32 index) const { return ptr[4 + index]; }
+    ND i32 getIntAt(c_u32 index) const { return static_cast<i32>(endian::load<Endian::Big, u32>(ptr + 4 + index * 4)); }
+    ND i64 getLongAt(c_u32 index) const { return static_cast<i64>(endian::load<Endian::Big, u64>(ptr + 4 + index * 8)); }
+
+    /// decodes all count elements at once into out, which must have room for them.
+    void getInts(i32* out) const { endian::loadArray<Endian::Big>(out, ptr + 4, count); }
+    void getLongs(i64* out) const { endian::loadArray<Endian::Big>(out, ptr + 4, count); }
+
+    /// decodes it into a tag, on the heap or in theArena.
+    ND NBTBase toTag(NBTArena* theArena = nullptr) const;
+};
+
+
+/**
+ * Receives the tags of an NBT stream as NBT::visit walks past them, so a query
+ * only pays for what it looks at and no tree is ever built.\n
+ * Names are empty for list elements; like the value views,
+ * they point into the input and are only valid while it is.
+ */
+class NBTVisitor {
+public:
+    virtual ~NBTVisitor() = default;
+
+    virtual NBTVisit onCompoundBegin(MU std::string_view name) { return NBTVisit::CONTINUE; }
+    virtual NBTVisit onCompoundEnd() { return NBTVisit::CONTINUE; }
+
+    /// elementType is NBT_NONE for empty lists.
+    virtual NBTVisit onListBegin(MU std::string_view name, MU NBTType elementType, MU u32 count) {
+        return NBTVisit::CONTINUE;
+    }
+    virtual NBTVisit onListEnd() { return NBTVisit::CONTINUE; }
+
+    /// every other tag: primitives, strings and arrays.
+    virtual NBTVisit onTag(MU std::string_view name, MU NBTType type, MU const NBTValueView& value) {
+        return NBTVisit::CONTINUE;
+    }
+};
@@ -42,42 +42,56 @@ static u32 RLE_NSX_OR_PS4_DECOMPRESS(u8* dataIn, c_u32 sizeIn, u8* dataOut, c_u3
 }
 
 
+/// the most RLE_NSXPS4_COMPRESS can write for sizeIn bytes, a lone zero takes two.
+static constexpr u32 RLE_NSXPS4_COMPRESS_BOUND(c_u32 sizeIn) {
+    return sizeIn * 2;
+}
+
+
 /**
  * A form of RLE compression.
  *
  * @param dataIn buffer_in to parseLayer from
  * @param sizeIn buffer_in size
  * @param dataOut a pointer to allocated buffer_out
- * @param sizeOut the size of the allocated buffer_out
+ * @param sizeOut the size of the allocated buffer_out, RLE_NSXPS4_COMPRESS_BOUND(sizeIn) always fits
+ * @return the compressed size, or 0 if it did not fit in sizeOut
  */
-static u32 RLE_NSXPS4_COMPRESS(c_u8* dataIn, c_u32 sizeIn, u8* dataOut, u32 sizeOut) {
+static u32 RLE_NSXPS4_COMPRESS(c_u8* dataIn, c_u32 sizeIn, u8* dataOut, c_u32 sizeOut) {
+    // the longest run one 4-byte token can hold, ((255 << 8) | 255) + 256
+    static constexpr u32 MAX_RUN = 0xFFFF + 256;
     u32 dataIndex = 0;
-    sizeOut = 0;
+    u32 indexOut = 0;
 
     while (dataIndex < sizeIn) {
         if (c_u8 value = dataIn[dataIndex]; value != 0) {
-            dataOut[sizeOut++] = value;
+            if (indexOut + 1 > sizeOut) {
+                return 0;
+            }
+            dataOut[indexOut++] = value;
+            dataIndex++;
             continue;
         }
 
         u32 runCount = 1;
-        while (dataIndex + runCount < sizeIn && dataIn[dataIndex + runCount] == 0) {
+        while (dataIndex + runCount < sizeIn && runCount < MAX_RUN && dataIn[dataIndex + runCount] == 0) {
             runCount++;
         }
 
+        if (indexOut + (runCount < 256 ? 2 : 4) > sizeOut) {
+            return 0;
+        }
         if (runCount < 256) {
-            dataOut[sizeOut++] = 0;
-            dataOut[sizeOut++] = runCount;
+            dataOut[indexOut++] = 0;
+            dataOut[indexOut++] = runCount;
         } else {
-            dataOut[sizeOut++] = 0;
-            dataOut[sizeOut++] = 0;
-            dataOut[sizeOut++] = (runCount >> 8) - 1;
-            dataOut[sizeOut++] = runCount & 255;
+            dataOut[indexOut++] = 0;
+            dataOut[indexOut++] = 0;
+            dataOut[indexOut++] = (runCount >> 8) - 1;
+            dataOut[indexOut++] = runCount & 255;
         }
 
         dataIndex += runCount;
     }
-    return sizeOut;
+    return indexOut;
 }
-
-
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <bit>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "lce/processor.hpp"
+
+#include "LegacyEditor/utils/dataManager.hpp"
+
+
+enum class Endian : bool {
+    Little = false,
+    Big = true,
+};
+
+
+namespace endian {
+
+    template<class T>
+    static constexpr T byteswap(T value) {
+        if constexpr (sizeof(T) == 1) {
+            return value;
+        } else {
+#if defined(__GNUC__) || defined(__clang__)
+            // the builtins are what lets loops over arrays become vector shuffles
+            if constexpr (sizeof(T) == 2) {
+                return static_cast<T>(__builtin_bswap16(static_cast<u16>(value)));
+            } else if constexpr (sizeof(T) == 4) {
+                return static_cast<T>(__builtin_bswap32(static_cast<u32>(value)));
+            } else if constexpr (sizeof(T) == 8) {
+                return static_cast<T>(__builtin_bswap64(static_cast<u64>(value)));
+            }
+#endif
+            T result = 0;
+            for (size_t i = 0; i < sizeof(T); i++) {
+                result = static_cast<T>(result << 8 | (value & 0xFF));
+                value = static_cast<T>(value >> 8);
+            }
+            return result;
+        }
+    }
+
+
+    template<Endian E>
+    static constexpr bool needsSwap() {
+        return (E == Endian::Big) != (std::endian::native == std::endian::big);
+    }
+
+
+    /// an unaligned load, plus a bswap if E is not the native endian.
+    template<Endian E, class T>
+    static T load(c_u8* ptr) {
+        static_assert(std::is_unsigned_v<T>);
+        T value;
+        std::memcpy(&value, ptr, sizeof(T));
+        if constexpr (needsSwap<E>()) {
+            value = byteswap(value);
+        }
+        return value;
+    }
+
+
+    template<Endian E, class T>
+    static void store(u8* ptr, T value) {
+        static_assert(std::is_unsigned_v<T>);
+        if constexpr (needsSwap<E>()) {
+            value = byteswap(value);
+        }
+        std::memcpy(ptr, &value, sizeof(T));
+    }
+
+
+    /// count values from ptr, as one copy and then one swap pass over them, which vectorizes.
+    template<Endian E, class T>
+    static void loadArray(T* valuesOut, c_u8* ptr, c_u64 count) {
+        static_assert(std::is_integral_v<T>);
+        using U = std::make_unsigned_t<T>;
+        std::memcpy(valuesOut, ptr, count * sizeof(T));
+        if constexpr (needsSwap<E>() && sizeof(T) > 1) {
+            U* values = reinterpret_cast<U*>(valuesOut);
+            for (u64 index = 0; index < count; index++) {
+                values[index] = byteswap(values[index]);
+            }
+        }
+    }
+
+
+    /// count values to ptr, see loadArray.
+    template<Endian E, class T>
+    static void storeArray(u8* ptr, const T* values, c_u64 count) {
+        static_assert(std::is_integral_v<T>);
+        using U = std::make_unsigned_t<T>;
+        if constexpr (needsSwap<E>() && sizeof(T) > 1) {
+            const U* valuesIn = reinterpret_cast<const U*>(values);
+            for (u64 index = 0; index < count; index++) {
+                const U value = byteswap(valuesIn[index]);
+                std::memcpy(ptr + index * sizeof(T), &value, sizeof(T));
+            }
+        } else {
+            std::memcpy(ptr, values, count * sizeof(T));
+        }
+    }
+
+}
+
+
+/**
+ * Reads from a DataManager's cursor with a fixed endian.\n
+ * It does not own anything; it advances the manager's ptr, so it can be
+ * mixed with the manager's own calls, and with views of the other endian.
+ */
+template<Endian E>
+class DataReader {
+    DataManager& myManager;
+
+    template<class T>
+    T read() {
+        const T value = endian::load<E, T>(myManager.ptr);
+        myManager.ptr += sizeof(T);
+        return value;
+    }
+
+public:
+    explicit DataReader(DataManager& theManager) : myManager(theManager) {}
+
+    ND DataManager& manager() const { return myManager; }
+
+    u8 readInt8() { return read<u8>(); }
+    u16 readInt16() { return read<u16>(); }
+    u32 readInt32() { return read<u32>(); }
+    u64 readInt64() { return read<u64>(); }
+    bool readBool() { return read<u8>() != 0; }
+
+    float readFloat() { return std::bit_cast<float>(read<u32>()); }
+    double readDouble() { return std::bit_cast<double>(read<u64>()); }
+
+    /// reads at offset from .data, not .ptr! Does not increment .ptr.
+    ND u16 readInt16AtOffset(c_u32 offset) const { return endian::load<E, u16>(myManager.data + offset); }
+    /// reads at offset from .data, not .ptr! Does not increment .ptr.
+    ND u32 readInt32AtOffset(c_u32 offset) const { return endian::load<E, u32>(myManager.data + offset); }
+    /// reads at offset from .data, not .ptr! Does not increment .ptr.
+    ND u64 readInt64AtOffset(c_u32 offset) const { return endian::load<E, u64>(myManager.data + offset); }
+
+    std::string readUTF() {
+        c_u16 length = readInt16();
+        std::string result(reinterpret_cast<char*>(myManager.ptr), length);
+        myManager.ptr += length;
+        return result;
+    }
+
+    void readBytes(c_u32 length, u8* dataOut) { myManager.readBytes(length, dataOut); }
+    u8* readBytes(c_u32 length) { return myManager.readBytes(length); }
+
+    /// count values in one go, see endian::loadArray.
+    template<class T>
+    void readArray(T* valuesOut, c_u32 count) {
+        endian::loadArray<E>(valuesOut, myManager.ptr, count);
+        myManager.ptr += static_cast<u64>(count) * sizeof(T);
+    }
+};
+
+
+/// Writes to a DataManager's cursor with a fixed endian, see DataReader.
+template<Endian E>
+class DataWriter {
+    DataManager& myManager;
+
+    template<class T>
+    void write(const T value) {
+        endian::store<E, T>(myManager.ptr, value);
+        myManager.ptr += sizeof(T);
+    }
+
+public:
+    explicit DataWriter(DataManager& theManager) : myManager(theManager) {}
+
+    ND DataManager& manager() const { return myManager; }
+
+    void writeInt8(c_u8 byteIn) { write<u8>(byteIn); }
+    void writeInt16(c_u16 shortIn) { write<u16>(shortIn); }
+    void writeInt32(c_u32 intIn) { write<u32>(intIn); }
+    void writeInt64(c_u64 longIn) { write<u64>(longIn); }
+
+    void writeFloat(const float floatIn) { write<u32>(std::bit_cast<u32>(floatIn)); }
+    void writeDouble(const double doubleIn) { write<u64>(std::bit_cast<u64>(doubleIn)); }
+
+    /// writes at offset from .data, not .ptr! Does not increment .ptr.
+    void writeInt16AtOffset(c_u32 offset, c_u16 shortIn) const { endian::store<E, u16>(myManager.data + offset, shortIn); }
+    /// writes at offset from .data, not .ptr! Does not increment .ptr.
+    void writeInt32AtOffset(c_u32 offset, c_u32 intIn) const { endian::store<E, u32>(myManager.data + offset, intIn); }
+    /// writes at offset from .data, not .ptr! Does not increment .ptr.
+    void writeInt64AtOffset(c_u32 offset, c_u64 longIn) const { endian::store<E, u64>(myManager.data + offset, longIn); }
+
+    void writeUTF(const std::string& str) {
+        writeInt16(static_cast<u16>(str.size()));
+        myManager.writeBytes(reinterpret_cast<c_u8*>(str.data()), str.size());
+    }
+
+    void writeBytes(c_u8* dataPtrIn, c_u32 length) { myManager.writeBytes(dataPtrIn, length); }
+
+    /// count values in one go, see endian::storeArray.
+    template<class T>
+    void writeArray(const T* values, c_u32 count) {
+        endian::storeArray<E>(myManager.ptr, values, count);
+        myManager.ptr += static_cast<u64>(count) * sizeof(T);
+    }
+};
+
+
+/**
+ * Picks the endian once, and calls func with it as a compile-time constant:
+ * func(std::integral_constant<Endian, E>).
+ */
+template<class Func>
+decltype(auto) withEndian(c_bool isBig, Func&& func) {
+    if (isBig) {
+        return func(std::integral_constant<Endian, Endian::Big>{});
+    }
+    return func(std::integral_constant<Endian, Endian::Little>{});
+}
@@ -0,0 +1,239 @@
+#include "deflateFile.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <new>
+
+#include "LegacyEditor/code/threaded.hpp"
+
+
+DeflateFileWriter::~DeflateFileWriter() {
+    close();
+}
+
+
+int DeflateFileWriter::open(const fs::path& thePath, c_int theLevel) {
+    close();
+
+    myInput = new(std::nothrow) u8[DICT_SIZE + BATCH_SIZE];
+    myBlocks = new(std::nothrow) Block[BATCH_BLOCKS];
+    if (myInput == nullptr || myBlocks == nullptr) {
+        close();
+        return printf_err(MALLOC_FAILED, ERROR_1, DICT_SIZE + BATCH_SIZE);
+    }
+
+    myFile = fopen(thePath.string().c_str(), "wb");
+    if (myFile == nullptr) {
+        close();
+        return printf_err(FILE_ERROR, "failed to write savefile to \"%s\"\n", thePath.string().c_str());
+    }
+
+    myLevel = theLevel == Z_DEFAULT_COMPRESSION ? 6 : theLevel;
+    myInputSize = 0;
+    myHasDictionary = false;
+    myAdler = adler32(0, nullptr, 0);
+    myRawSize = 0;
+    myInflatedSize = 0;
+    myDeflatedSize = 0;
+    myStreamOpen = true;
+    return SUCCESS;
+}
+
+
+int DeflateFileWriter::writeRaw(c_u8* theData, c_u32 theSize) {
+    if (myFile == nullptr || myInflatedSize != 0 || myDeflatedSize != 0) {
+        return INVALID_ARGUMENT;
+    }
+    if (fwrite(theData, 1, theSize, myFile) != theSize) {
+        return FILE_ERROR;
+    }
+    myRawSize += theSize;
+    return SUCCESS;
+}
+
+
+int DeflateFileWriter::writeOut(c_u8* theData, c_u32 theSize) {
+    if (fwrite(theData, 1, theSize, myFile) != theSize) {
+        return FILE_ERROR;
+    }
+    myDeflatedSize += theSize;
+    return SUCCESS;
+}
+
+
+int DeflateFileWriter::write(c_u8* theData, u32 theSize) {
+    if (!myStreamOpen) {
+        return INVALID_ARGUMENT;
+    }
+    myInflatedSize += theSize;
+    while (theSize != 0) {
+        // a full batch is only deflated once more input shows it is not the last
+        if (myInputSize == BATCH_SIZE) {
+            if (c_int status = deflateBatch(false); status != SUCCESS) {
+                return status;
+            }
+        }
+        c_u32 amount = std::min(theSize, BATCH_SIZE - myInputSize);
+        std::memcpy(myInput + DICT_SIZE + myInputSize, theData, amount);
+        myInputSize += amount;
+        theData += amount;
+        theSize -= amount;
+    }
+    return SUCCESS;
+}
+
+
+/**
+ * Deflates one block as raw deflate, primed with the DICT_SIZE bytes in front of it.
+ * A sync flush ends it on a byte boundary with the final bit unset, so the next
+ * block's output can follow it directly; only the last block finishes the stream.
+ */
+void DeflateFileWriter::deflateBlock(c_u32 theIndex, const bool isLast) {
+    Block& block = myBlocks[theIndex];
+    c_u32 offset = theIndex * BLOCK_SIZE;
+    c_u8* blockIn = myInput + DICT_SIZE + offset;
+    c_u32 blockSize = std::min(BLOCK_SIZE, myInputSize - offset);
+
+    z_stream stream{};
+    if (deflateInit2(&stream, myLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        block.status = COMPRESS;
+        return;
+    }
+    if (theIndex != 0 || myHasDictionary) {
+        deflateSetDictionary(&stream, blockIn - DICT_SIZE, DICT_SIZE);
+    }
+
+    block.out.clear();
+    if (!block.out.reserve(deflateBound(&stream, blockSize) + 16)) {
+        deflateEnd(&stream);
+        block.status = MALLOC_FAILED;
+        return;
+    }
+
+    // zlib does not write through next_in
+    stream.next_in = const_cast<u8*>(blockIn);
+    stream.avail_in = blockSize;
+    c_int flush = isLast ? Z_FINISH : Z_SYNC_FLUSH;
+    block.status = SUCCESS;
+    while (true) {
+        stream.next_out = block.out.data() + stream.total_out;
+        stream.avail_out = block.out.capacity() - stream.total_out;
+        c_int status = deflate(&stream, flush);
+        if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR) {
+            block.status = COMPRESS;
+            break;
+        }
+        if (isLast ? status == Z_STREAM_END : stream.avail_out != 0) {
+            break;
+        }
+        // the bound is only short by the flush marker, it rarely comes to this
+        block.out.seek(stream.total_out);
+        if (!block.out.reserve(block.out.capacity() * 2)) {
+            block.status = MALLOC_FAILED;
+            break;
+        }
+    }
+    block.out.seek(stream.total_out);
+    deflateEnd(&stream);
+
+    block.adler = adler32(adler32(0, nullptr, 0), blockIn, blockSize);
+}
+
+
+int DeflateFileWriter::deflateBatch(const bool isLast) {
+    int status;
+
+    // an empty stream still needs its final block
+    u32 blockCount = (myInputSize + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    if (blockCount == 0) {
+        blockCount = 1;
+    }
+
+    run_parallel<THREAD_COUNT>(std::function<void(int)>([this, blockCount, isLast](c_int theThread) {
+        for (u32 index = theThread; index < blockCount; index += THREAD_COUNT) {
+            deflateBlock(index, isLast && index == blockCount - 1);
+        }
+    }));
+
+    // the zlib header, with the level hint deflate() would have given it
+    if (myDeflatedSize == 0) {
+        c_u32 levelFlags = myLevel < 2 ? 0 : myLevel < 6 ? 1 : myLevel == 6 ? 2 : 3;
+        u32 header = (Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8 | levelFlags << 6;
+        header += 31 - header % 31;
+        c_u8 headerBytes[2] = {static_cast<u8>(header >> 8), static_cast<u8>(header)};
+        if ((status = writeOut(headerBytes, 2)) != SUCCESS) {
+            return status;
+        }
+    }
+
+    for (u32 index = 0; index < blockCount; index++) {
+        const Block& block = myBlocks[index];
+        if (block.status != SUCCESS) {
+            return block.status;
+        }
+        if ((status = writeOut(block.out.data(), block.out.size())) != SUCCESS) {
+            return status;
+        }
+        c_u32 blockSize = std::min(BLOCK_SIZE, myInputSize - index * BLOCK_SIZE);
+        myAdler = adler32_combine(myAdler, block.adler, blockSize);
+    }
+
+    // the next batch's first block is primed with the end of this one
+    if (!isLast) {
+        std::memcpy(myInput, myInput + myInputSize, DICT_SIZE);
+        myHasDictionary = true;
+    }
+    myInputSize = 0;
+    return SUCCESS;
+}
+
+
+int DeflateFileWriter::finish() {
+    if (!myStreamOpen) {
+        return INVALID_ARGUMENT;
+    }
+    myStreamOpen = false;
+
+    int status = deflateBatch(true);
+    if (status != SUCCESS) {
+        return status;
+    }
+
+    c_u8 trailer[4] = {
+            static_cast<u8>(myAdler >> 24), static_cast<u8>(myAdler >> 16),
+            static_cast<u8>(myAdler >> 8), static_cast<u8>(myAdler)};
+    if ((status = writeOut(trailer, 4)) != SUCCESS) {
+        return status;
+    }
+    return fflush(myFile) == 0 ? SUCCESS : FILE_ERROR;
+}
+
+
+int DeflateFileWriter::patch(c_u64 theOffset, c_u8* theData, c_u32 theSize) {
+    if (myFile == nullptr || myStreamOpen || theOffset + theSize > myRawSize) {
+        return INVALID_ARGUMENT;
+    }
+    if (fseek(myFile, static_cast<long>(theOffset), SEEK_SET) != 0
+        || fwrite(theData, 1, theSize, myFile) != theSize
+        || fseek(myFile, 0, SEEK_END) != 0) {
+        return FILE_ERROR;
+    }
+    return SUCCESS;
+}
+
+
+int DeflateFileWriter::close() {
+    int status = SUCCESS;
+    myStreamOpen = false;
+    if (myFile != nullptr) {
+        if (fclose(myFile) != 0) {
+            status = FILE_ERROR;
+        }
+        myFile = nullptr;
+    }
+    delete[] myInput;
+    myInput = nullptr;
+    delete[] myBlocks;
+    myBlocks = nullptr;
+    return status;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdio>
+
+#include "include/ghc/fs_std.hpp"
+#include "include/zlib-1.2.12/zlib.h"
+
+#include "lce/processor.hpp"
+
+#include "LegacyEditor/utils/error_status.hpp"
+#include "LegacyEditor/utils/outputBuffer.hpp"
+
+
+/**
+ * Deflates a zlib stream straight into a file.\n
+ * Input is fed in whatever pieces the caller has, and gathered into batches of
+ * BLOCK_SIZE blocks. Each batch is deflated on THREAD_COUNT threads, every block
+ * primed with the 32KB before it and ended with a sync flush, so the blocks
+ * join into one standard zlib stream; the adler32 is combined from each block's.\n
+ * Only a batch and its output are ever in memory.\n
+ * Raw bytes (headers) can be written in front of the stream, and patched afterward.
+ */
+class DeflateFileWriter {
+public:
+    static constexpr u32 BLOCK_SIZE = 128 * 1024;
+    static constexpr u32 DICT_SIZE = 32 * 1024;
+    static constexpr u32 BATCH_BLOCKS = 32;
+    static constexpr u32 BATCH_SIZE = BLOCK_SIZE * BATCH_BLOCKS;
+    static constexpr int THREAD_COUNT = 4;
+
+private:
+    struct Block {
+        OutputBuffer out;
+        u32 adler = 1;
+        int status = SUCCESS;
+    };
+
+    FILE* myFile = nullptr;
+    int myLevel = Z_DEFAULT_COMPRESSION;
+    /// the previous batch's last DICT_SIZE bytes, then the batch
+    u8* myInput = nullptr;
+    u32 myInputSize = 0;
+    bool myHasDictionary = false;
+    Block* myBlocks = nullptr;
+
+    u32 myAdler = 1;
+    u64 myRawSize = 0;
+    u64 myInflatedSize = 0;
+    u64 myDeflatedSize = 0;
+    bool myStreamOpen = false;
+
+    void deflateBlock(u32 theIndex, bool isLast);
+    int deflateBatch(bool isLast);
+    int writeOut(c_u8* theData, u32 theSize);
+
+public:
+    DeflateFileWriter() = default;
+    ~DeflateFileWriter();
+
+    DeflateFileWriter(const DeflateFileWriter&) = delete;
+    DeflateFileWriter& operator=(const DeflateFileWriter&) = delete;
+
+    /// @return SUCCESS, FILE_ERROR or MALLOC_FAILED.
+    int open(const fs::path& thePath, int theLevel = Z_DEFAULT_COMPRESSION);
+
+    /// writes bytes uncompressed, only valid before the first write().
+    int writeRaw(c_u8* theData, u32 theSize);
+    /// deflates theSize bytes into the stream.
+    int write(c_u8* theData, u32 theSize);
+    /// ends the stream and flushes what is left of it.
+    int finish();
+    /// overwrites already written raw bytes at theOffset, only valid after finish().
+    int patch(u64 theOffset, c_u8* theData, u32 theSize);
+    /// closes the file, discarding the stream if it was not finished.
+    int close();
+
+    /// bytes fed to write() so far.
+    ND u64 getInflatedSize() const { return myInflatedSize; }
+    /// bytes of the zlib stream on disk so far.
+    ND u64 getDeflatedSize() const { return myDeflatedSize; }
+    /// raw bytes + the deflated stream.
+    ND u64 getFileSize() const { return myRawSize + myDeflatedSize; }
+};
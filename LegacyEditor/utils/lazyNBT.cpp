@@ -0,0 +1,92 @@
+#include "lazyNBT.hpp"
+
+#include "LegacyEditor/utils/NBT.hpp"
+#include "LegacyEditor/utils/dataReader.hpp"
+#include "LegacyEditor/utils/error_status.hpp"
+#include "LegacyEditor/utils/outputBuffer.hpp"
+
+
+LazyNBT::~LazyNBT() {
+    reset();
+    delete myArena;
+}
+
+
+void LazyNBT::readRaw(DataManager& input) {
+    reset();
+    u8* start = input.ptr;
+    u8* end = input.data + input.size;
+
+    // the name and payload are jumped over, nothing is decoded
+    bool isValid = end - start >= 3 && start[0] != NBT_NONE;
+    if (isValid) {
+        input.incrementPointer(3 + endian::load<Endian::Big, u16>(start + 1));
+        isValid = input.ptr <= end && NBT::skip(static_cast<NBTType>(start[0]), input) == SUCCESS;
+    }
+    // whatever it is, it is kept as far as the data goes, the same as the tree reader would see it
+    if (!isValid) {
+        input.ptr = end;
+    }
+    myBytes.assign(start, input.ptr);
+}
+
+
+void LazyNBT::set(NBTBase* theTag) {
+    // one made in the arena keeps it, whatever was in it before is dropped with it later
+    if (theTag != nullptr && theTag->isArenaOwned) {
+        freeTag();
+        myBytes.clear();
+    } else {
+        reset();
+    }
+    myTag = theTag;
+}
+
+
+NBTBase* LazyNBT::get() {
+    if (myTag == nullptr && !myBytes.empty()) {
+        DataManager managerIn(myBytes.data(), static_cast<u32>(myBytes.size()));
+        myTag = NBT::readTag(managerIn, getArena());
+        std::vector<u8>().swap(myBytes);
+    }
+    if (myTag != nullptr) {
+        myTag->makeUnique();
+    }
+    return myTag;
+}
+
+
+NBTArena& LazyNBT::getArena() {
+    if (myArena == nullptr) {
+        myArena = new NBTArena();
+    }
+    return *myArena;
+}
+
+
+void LazyNBT::write(OutputBuffer& output) const {
+    if (myTag != nullptr) {
+        NBT::writeTag(myTag, output);
+    } else if (!myBytes.empty()) {
+        output.writeBytes(myBytes.data(), static_cast<u32>(myBytes.size()));
+    }
+}
+
+
+void LazyNBT::freeTag() {
+    if (myTag != nullptr && !myTag->isArenaOwned) {
+        myTag->NbtFree();
+        delete myTag;
+    }
+    myTag = nullptr;
+}
+
+
+void LazyNBT::reset() {
+    freeTag();
+    // a parsed tree is dropped all at once
+    if (myArena != nullptr) {
+        myArena->release();
+    }
+    myBytes.clear();
+}
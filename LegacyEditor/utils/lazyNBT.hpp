@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include "lce/processor.hpp"
+
+
+class DataManager;
+class NBTArena;
+class NBTBase;
+class OutputBuffer;
+
+
+/**
+ * An NBT tag kept as the bytes it was read from until it is first asked for.\n
+ * Chunks hold their Entities / TileEntities / TileTicks in one, so reading and
+ * writing a chunk for its blocks alone copies them through untouched,
+ * instead of parsing, re-serializing and freeing a tree.
+ */
+class LazyNBT {
+    std::vector<u8> myBytes;
+    NBTBase* myTag = nullptr;
+    /// what myTag is parsed into, kept for the next one.
+    NBTArena* myArena = nullptr;
+
+    void freeTag();
+
+public:
+    LazyNBT() = default;
+    ~LazyNBT();
+
+    LazyNBT(const LazyNBT&) = delete;
+    LazyNBT& operator=(const LazyNBT&) = delete;
+
+    /// takes a copy of the tag at input's cursor without parsing it, and moves past it.
+    void readRaw(DataManager& input);
+
+    /**
+     * Takes over theTag, which is either on the heap or made in getArena().
+     * A heap tag may be shared (NBTBase::share), a template set into many chunks is then never copied.
+     */
+    void set(NBTBase* theTag);
+
+    /**
+     * Parses the bytes on the first call.
+     * The caller may change what it gets, so from then on it is written from the tree,
+     * and a shared tag is made unique; the tags below it are as the getters reach them.
+     * @return the tag, or nullptr if there is none.
+     */
+    ND NBTBase* get();
+
+    /// what get() parses into, tags made in it live as long as it does.
+    ND NBTArena& getArena();
+
+    /// the original bytes if it was never parsed, else the tree.
+    void write(OutputBuffer& output) const;
+
+    void reset();
+
+    ND bool isEmpty() const { return myTag == nullptr && myBytes.empty(); }
+    ND bool isParsed() const { return myTag != nullptr; }
+    /// the untouched bytes, empty once it is parsed.
+    ND const std::vector<u8>& getBytes() const { return myBytes; }
+};
@@ -0,0 +1,141 @@
+#include "mappedFile.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "LegacyEditor/utils/error_status.hpp"
+
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+
+int MappedFile::open(const fs::path& thePath, const bool isCopyOnWrite) {
+    close();
+    const std::string pathStr = thePath.string();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(thePath.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return printf_err(FILE_ERROR, ERROR_4, pathStr.c_str());
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart > 0xFFFFFFFF) {
+        CloseHandle(file);
+        return printf_err(FILE_ERROR, ERROR_4, pathStr.c_str());
+    }
+    myFileHandle = file;
+    mySize = static_cast<u32>(fileSize.QuadPart);
+
+    // an empty file can't be mapped, it is just empty
+    if (mySize != 0) {
+        myMapHandle = CreateFileMappingW(file, nullptr, isCopyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY,
+                                         0, 0, nullptr);
+        if (myMapHandle != nullptr) {
+            myData = static_cast<u8*>(MapViewOfFile(myMapHandle, isCopyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ,
+                                                    0, 0, 0));
+        }
+        if (myData == nullptr) {
+            close();
+            return printf_err(FILE_ERROR, ERROR_4, pathStr.c_str());
+        }
+    }
+#else
+    c_int file = ::open(pathStr.c_str(), O_RDONLY);
+    if (file < 0) {
+        return printf_err(FILE_ERROR, ERROR_4, pathStr.c_str());
+    }
+    struct stat fileStat{};
+    if (fstat(file, &fileStat) != 0 || fileStat.st_size > 0xFFFFFFFF) {
+        ::close(file);
+        return printf_err(FILE_ERROR, ERROR_4, pathStr.c_str());
+    }
+    mySize = static_cast<u32>(fileStat.st_size);
+
+    // an empty file can't be mapped, it is just empty
+    if (mySize != 0) {
+        c_int protection = isCopyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* mapping = mmap(nullptr, mySize, protection, MAP_PRIVATE, file, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(file);
+            mySize = 0;
+            return printf_err(FILE_ERROR, ERROR_4, pathStr.c_str());
+        }
+        // it is read front to back
+        madvise(mapping, mySize, MADV_SEQUENTIAL);
+        myData = static_cast<u8*>(mapping);
+    }
+    // the mapping keeps the file open
+    ::close(file);
+#endif
+
+    myPath = thePath;
+    return SUCCESS;
+}
+
+
+void MappedFile::prefetch(c_u32 theOffset) {
+    stopPrefetch();
+    if (theOffset >= mySize) {
+        return;
+    }
+
+    myStopPrefetch = false;
+    myPrefetcher = std::thread([this, theOffset] {
+        constexpr u32 PAGE_STRIDE = 4096;
+        volatile u8 sink = 0;
+        for (u32 window = theOffset; window < mySize && !myStopPrefetch; window += PREFETCH_WINDOW) {
+            c_u32 windowEnd = mySize - window < PREFETCH_WINDOW ? mySize : window + PREFETCH_WINDOW;
+#ifndef _WIN32
+            // lets the kernel start the whole window's reads before the first touch blocks
+            c_u32 pageStart = window & ~(PAGE_STRIDE - 1);
+            madvise(myData + pageStart, windowEnd - pageStart, MADV_WILLNEED);
+#endif
+            for (u32 page = window; page < windowEnd; page += PAGE_STRIDE) {
+                sink = sink + myData[page];
+            }
+        }
+    });
+}
+
+
+void MappedFile::stopPrefetch() {
+    if (myPrefetcher.joinable()) {
+        myStopPrefetch = true;
+        myPrefetcher.join();
+    }
+}
+
+
+void MappedFile::close() {
+    // the prefetcher reads the mapping, it has to stop before it is unmapped
+    stopPrefetch();
+#ifdef _WIN32
+    if (myData != nullptr) {
+        UnmapViewOfFile(myData);
+    }
+    if (myMapHandle != nullptr) {
+        CloseHandle(myMapHandle);
+        myMapHandle = nullptr;
+    }
+    if (myFileHandle != nullptr) {
+        CloseHandle(myFileHandle);
+        myFileHandle = nullptr;
+    }
+#else
+    if (myData != nullptr) {
+        munmap(myData, mySize);
+    }
+#endif
+    myData = nullptr;
+    mySize = 0;
+    myPath.clear();
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "include/ghc/fs_std.hpp"
+
+#include "lce/processor.hpp"
+
+#include "LegacyEditor/utils/data.hpp"
+
+
+/**
+ * A read-only memory mapping of a whole file.\n
+ * Readers go through the page cache instead of copying the file onto the heap,
+ * so it must outlive anything view()'d from it.
+ * The pages are read-only, writing to them faults, unless it is opened copy-on-write;
+ * then written pages become private copies and the file itself is never changed.
+ */
+class MappedFile {
+    u8* myData = nullptr;
+    u32 mySize = 0;
+    fs::path myPath;
+    std::thread myPrefetcher;
+    std::atomic<bool> myStopPrefetch = false;
+#ifdef _WIN32
+    void* myFileHandle = nullptr;
+    void* myMapHandle = nullptr;
+#endif
+
+public:
+    static constexpr u32 PREFETCH_WINDOW = 1024 * 1024;
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// @return SUCCESS or FILE_ERROR.
+    int open(const fs::path& thePath, bool isCopyOnWrite = false);
+    void close();
+
+    /**
+     * Faults the pages from theOffset on into the page cache on a background thread,
+     * PREFETCH_WINDOW at a time, so a reader walking the mapping front to back
+     * overlaps its work with the disk instead of waiting on every fault.
+     */
+    void prefetch(u32 theOffset = 0);
+    /// stops and joins the prefetch thread, close() does this too.
+    void stopPrefetch();
+
+    ND bool isOpen() const { return !myPath.empty(); }
+    ND const fs::path& getPath() const { return myPath; }
+    ND u8* data() const { return myData; }
+    ND u32 size() const { return mySize; }
+
+    /// borrows the mapping, never deallocate() it.
+    ND Data view() const { return Data(myData, mySize); }
+};
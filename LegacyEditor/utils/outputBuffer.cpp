@@ -0,0 +1,138 @@
+#include "outputBuffer.hpp"
+
+#include <cstring>
+#include <new>
+
+
+OutputBuffer::OutputBuffer(c_u32 theCapacity) {
+    if (!reserve(theCapacity)) {
+        throw std::bad_alloc();
+    }
+}
+
+
+OutputBuffer::~OutputBuffer() {
+    delete[] myData;
+}
+
+
+OutputBuffer::OutputBuffer(OutputBuffer&& other) noexcept
+    : myData(other.myData), myCapacity(other.myCapacity),
+      mySize(other.mySize), myPosition(other.myPosition) {
+    other.myData = nullptr;
+    other.clear();
+    other.myCapacity = 0;
+}
+
+
+OutputBuffer& OutputBuffer::operator=(OutputBuffer&& other) noexcept {
+    if (this != &other) {
+        delete[] myData;
+        myData = other.myData;
+        myCapacity = other.myCapacity;
+        mySize = other.mySize;
+        myPosition = other.myPosition;
+        other.myData = nullptr;
+        other.clear();
+        other.myCapacity = 0;
+    }
+    return *this;
+}
+
+
+bool OutputBuffer::reserve(c_u32 theCapacity) {
+    if (theCapacity <= myCapacity) {
+        return true;
+    }
+
+    u8* newData = new(std::nothrow) u8[theCapacity];
+    if (newData == nullptr) {
+        return false;
+    }
+#ifndef NDEBUG
+    // so writers that rely on zeroed memory stand out
+    std::memset(newData, 0xCD, theCapacity);
+#endif
+    if (myData != nullptr) {
+        std::memcpy(newData, myData, size());
+        delete[] myData;
+    }
+    myData = newData;
+    myCapacity = theCapacity;
+    return true;
+}
+
+
+/// at least doubles, so N bytes of small writes only copy O(N) bytes in total.
+void OutputBuffer::grow(c_u32 theAmount) {
+    u64 newCapacity = myCapacity < MIN_CAPACITY ? MIN_CAPACITY : u64(myCapacity) * 2;
+    if (newCapacity < u64(myPosition) + theAmount) {
+        newCapacity = u64(myPosition) + theAmount;
+    }
+    if (newCapacity > 0xFFFFFFFF || !reserve(static_cast<u32>(newCapacity))) {
+        throw std::bad_alloc();
+    }
+}
+
+
+void OutputBuffer::seek(c_u32 thePosition) {
+    mySize = size();
+    if (thePosition > myCapacity && !reserve(thePosition)) {
+        throw std::bad_alloc();
+    }
+    myPosition = thePosition;
+}
+
+
+void OutputBuffer::truncate(c_u32 theSize) {
+    assert(theSize <= size());
+    mySize = theSize;
+    myPosition = theSize;
+}
+
+
+/// keeps the memory, for reusing the buffer.
+void OutputBuffer::clear() {
+    mySize = 0;
+    myPosition = 0;
+}
+
+
+void OutputBuffer::adopt(Data& theData) {
+    delete[] myData;
+    myData = theData.data;
+    myCapacity = theData.size;
+    mySize = theData.size;
+    myPosition = theData.size;
+    theData.reset();
+}
+
+
+Data OutputBuffer::release() {
+    Data dataOut(myData, size());
+    myData = nullptr;
+    myCapacity = 0;
+    clear();
+    return dataOut;
+}
+
+
+DataManager OutputBuffer::view(c_u32 theAmount) {
+    ensure(theAmount);
+    DataManager managerOut(myData, myPosition + theAmount);
+    managerOut.ptr = myData + myPosition;
+    return managerOut;
+}
+
+
+void OutputBuffer::commit(const DataManager& theManager) {
+    assert(theManager.data == myData && theManager.getPosition() <= myCapacity);
+    seek(theManager.getPosition());
+}
+
+
+void OutputBuffer::fill(c_u8 theValue, c_u32 theLength) {
+    ensure(theLength);
+    std::memset(myData + myPosition, theValue, theLength);
+    myPosition += theLength;
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cassert>
+#include <string>
+
+#include "lce/processor.hpp"
+
+#include "LegacyEditor/utils/data.hpp"
+#include "LegacyEditor/utils/dataManager.hpp"
+#include "LegacyEditor/utils/dataReader.hpp"
+
+
+/**
+ * A growable output buffer, for writers that can't know their size up front.\n
+ * Checked writes grow it geometrically; the *Unchecked writes are the fast
+ * path for after an ensure(), and are only bounds checked in debug builds.\n
+ * Memory is not zeroed, writers must fill every byte they skip over.
+ */
+class OutputBuffer {
+    u8* myData = nullptr;
+    u32 myCapacity = 0;
+    u32 mySize = 0;
+    u32 myPosition = 0;
+
+    void grow(u32 theAmount);
+
+public:
+    static constexpr u32 MIN_CAPACITY = 256;
+
+    OutputBuffer() = default;
+    explicit OutputBuffer(u32 theCapacity);
+    ~OutputBuffer();
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+    OutputBuffer(OutputBuffer&& other) noexcept;
+    OutputBuffer& operator=(OutputBuffer&& other) noexcept;
+
+    ND u8* data() const { return myData; }
+    ND u32 capacity() const { return myCapacity; }
+    /// the furthest byte written, seeking backwards does not shrink it.
+    ND u32 size() const { return myPosition > mySize ? myPosition : mySize; }
+    ND u32 getPosition() const { return myPosition; }
+
+    /// grows the capacity to at least theCapacity, keeping the contents.
+    bool reserve(u32 theCapacity);
+
+    /// makes room for theAmount more bytes after the position.
+    void ensure(c_u32 theAmount) {
+        if EXPECT_FALSE (theAmount > myCapacity - myPosition) {
+            grow(theAmount);
+        }
+    }
+
+    void seek(u32 thePosition);
+    /// drops everything from theSize on, and moves the position there.
+    void truncate(u32 theSize);
+    void clear();
+
+    /// takes ownership of theData's buffer without copying, and appends after it.
+    void adopt(Data& theData);
+    /// gives up the buffer without copying, the Data's size is size().
+    ND Data release();
+
+    /**
+     * A DataManager over [0, position + theAmount), with its cursor at the position,
+     * for writers that seek / patch and have a known upper bound.
+     * Hand it back to commit() afterward.
+     */
+    ND DataManager view(u32 theAmount);
+    /// moves the position to where theManager, from view(), stopped writing.
+    void commit(const DataManager& theManager);
+
+    // CHECKED WRITES
+
+    template<Endian E = Endian::Big, class T>
+    void write(const T value) {
+        ensure(sizeof(T));
+        writeUnchecked<E, T>(value);
+    }
+
+    void writeBytes(c_u8* theData, c_u32 theLength) {
+        ensure(theLength);
+        writeBytesUnchecked(theData, theLength);
+    }
+
+    template<Endian E = Endian::Big, class T>
+    void writeArray(const T* theValues, c_u32 theCount) {
+        ensure(static_cast<u32>(theCount * sizeof(T)));
+        writeArrayUnchecked<E, T>(theValues, theCount);
+    }
+
+    void fill(u8 theValue, u32 theLength);
+
+    /// writes at offset from the start, not the position! It must have already been written.
+    template<Endian E = Endian::Big, class T>
+    void writeAtOffset(c_u32 theOffset, const T value) {
+        assert(theOffset + sizeof(T) <= size());
+        endian::store<E, T>(myData + theOffset, value);
+    }
+
+    // UNCHECKED WRITES
+
+    template<Endian E = Endian::Big, class T>
+    void writeUnchecked(const T value) {
+        assert(sizeof(T) <= myCapacity - myPosition);
+        endian::store<E, T>(myData + myPosition, value);
+        myPosition += sizeof(T);
+    }
+
+    void writeBytesUnchecked(c_u8* theData, c_u32 theLength) {
+        assert(theLength <= myCapacity - myPosition);
+        std::memcpy(myData + myPosition, theData, theLength);
+        myPosition += theLength;
+    }
+
+    template<Endian E = Endian::Big, class T>
+    void writeArrayUnchecked(const T* theValues, c_u32 theCount) {
+        assert(theCount * sizeof(T) <= myCapacity - myPosition);
+        endian::storeArray<E>(myData + myPosition, theValues, theCount);
+        myPosition += static_cast<u32>(theCount * sizeof(T));
+    }
+};
+
+
+/// Writes to an OutputBuffer with a fixed endian, with the same calls as DataWriter.
+template<Endian E>
+class BufferWriter {
+    OutputBuffer& myBuffer;
+
+public:
+    explicit BufferWriter(OutputBuffer& theBuffer) : myBuffer(theBuffer) {}
+
+    ND OutputBuffer& buffer() const { return myBuffer; }
+
+    void writeInt8(c_u8 byteIn) { myBuffer.write<E, u8>(byteIn); }
+    void writeInt16(c_u16 shortIn) { myBuffer.write<E, u16>(shortIn); }
+    void writeInt32(c_u32 intIn) { myBuffer.write<E, u32>(intIn); }
+    void writeInt64(c_u64 longIn) { myBuffer.write<E, u64>(longIn); }
+
+    void writeFloat(const float floatIn) { myBuffer.write<E, u32>(std::bit_cast<u32>(floatIn)); }
+    void writeDouble(const double doubleIn) { myBuffer.write<E, u64>(std::bit_cast<u64>(doubleIn)); }
+
+    void writeUTF(const std::string& str) {
+        myBuffer.ensure(2 + str.size());
+        myBuffer.writeUnchecked<E, u16>(static_cast<u16>(str.size()));
+        myBuffer.writeBytesUnchecked(reinterpret_cast<c_u8*>(str.data()), str.size());
+    }
+
+    void writeBytes(c_u8* dataPtrIn, c_u32 length) { myBuffer.writeBytes(dataPtrIn, length); }
+
+    template<class T>
+    void writeArray(const T* values, c_u32 count) { myBuffer.writeArray<E, T>(values, count); }
+};
+
+
+/**
+ * BufferWriter over the unchecked writes, for when the exact size is known
+ * (see NBT::serializedSize) and has been ensure()d up front.
+ */
+template<Endian E>
+class UncheckedBufferWriter {
+    OutputBuffer& myBuffer;
+
+public:
+    explicit UncheckedBufferWriter(OutputBuffer& theBuffer) : myBuffer(theBuffer) {}
+
+    ND OutputBuffer& buffer() const { return myBuffer; }
+
+    void writeInt8(c_u8 byteIn) { myBuffer.writeUnchecked<E, u8>(byteIn); }
+    void writeInt16(c_u16 shortIn) { myBuffer.writeUnchecked<E, u16>(shortIn); }
+    void writeInt32(c_u32 intIn) { myBuffer.writeUnchecked<E, u32>(intIn); }
+    void writeInt64(c_u64 longIn) { myBuffer.writeUnchecked<E, u64>(longIn); }
+
+    void writeFloat(const float floatIn) { myBuffer.writeUnchecked<E, u32>(std::bit_cast<u32>(floatIn)); }
+    void writeDouble(const double doubleIn) { myBuffer.writeUnchecked<E, u64>(std::bit_cast<u64>(doubleIn)); }
+
+    void writeUTF(const std::string& str) {
+        myBuffer.writeUnchecked<E, u16>(static_cast<u16>(str.size()));
+        myBuffer.writeBytesUnchecked(reinterpret_cast<c_u8*>(str.data()), str.size());
+    }
+
+    void writeBytes(c_u8* dataPtrIn, c_u32 length) { myBuffer.writeBytesUnchecked(dataPtrIn, length); }
+
+    template<class T>
+    void writeArray(const T* values, c_u32 count) { myBuffer.writeArrayUnchecked<E, T>(values, count); }
+};